@@ -0,0 +1,91 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace detail
+{
+
+bool benchSelected(const Bench& bench, const std::string& name)
+{
+    return bench.filter.empty() || name.find(bench.filter) != std::string::npos;
+}
+
+void benchAddResult(Bench& bench, const std::string& name, std::size_t items, std::vector<double> samplesNs)
+{
+    BenchResult result;
+    result.name = name;
+    result.items = std::max<std::size_t>(items, 1);
+    result.repetitions = samplesNs.size();
+
+    if(!samplesNs.empty())
+    {
+        for(auto& sample : samplesNs)
+        {
+            sample /= result.items;
+        }
+        std::sort(samplesNs.begin(), samplesNs.end());
+
+        double sum = 0.0;
+        for(auto sample : samplesNs)
+        {
+            sum += sample;
+        }
+        result.meanNs = sum / samplesNs.size();
+
+        double variance = 0.0;
+        for(auto sample : samplesNs)
+        {
+            variance += (sample - result.meanNs) * (sample - result.meanNs);
+        }
+        result.stddevNs = samplesNs.size() > 1 ? std::sqrt(variance / (samplesNs.size() - 1)) : 0.0;
+
+        std::size_t middle = samplesNs.size() / 2;
+        result.medianNs = samplesNs.size() % 2 ? samplesNs[middle] : 0.5 * (samplesNs[middle - 1] + samplesNs[middle]);
+        result.minNs = samplesNs.front();
+        result.maxNs = samplesNs.back();
+        result.itemsPerSecond = result.medianNs > 0.0 ? 1e9 / result.medianNs : 0.0;
+    }
+
+    std::cout << "    " << std::left << std::setw(36) << result.name << std::right << std::fixed << std::setprecision(2)
+              << " median " << std::setw(12) << result.medianNs << " ns, stddev " << std::setw(10) << result.stddevNs
+              << " ns, min " << std::setw(12) << result.minNs << " ns" << std::endl;
+    std::cout << std::defaultfloat;
+
+    bench.results.push_back(std::move(result));
+}
+
+}
+
+bool benchWriteReport(const Bench& bench, const std::string& path)
+{
+    std::ofstream file(path);
+    if(!file)
+    {
+        std::cerr << "[Bench] could not open " << path << std::endl;
+        return false;
+    }
+
+    file << "{\n";
+    file << "  \"warmup\": " << bench.warmup << ",\n";
+    file << "  \"repetitions\": " << bench.repetitions << ",\n";
+    file << "  \"benchmarks\": [\n";
+    for(unsigned int i = 0; i < bench.results.size(); i++)
+    {
+        const BenchResult& result = bench.results[i];
+        file << "    {\"name\": \"" << result.name << "\", \"items\": " << result.items
+             << ", \"repetitions\": " << result.repetitions
+             << ", \"minNs\": " << result.minNs << ", \"medianNs\": " << result.medianNs
+             << ", \"meanNs\": " << result.meanNs << ", \"stddevNs\": " << result.stddevNs
+             << ", \"maxNs\": " << result.maxNs << ", \"itemsPerSecond\": " << result.itemsPerSecond << "}"
+             << (i + 1 < bench.results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n";
+    file << "}\n";
+
+    std::cout << "[Bench] " << bench.results.size() << " benchmarks written to " << path << std::endl;
+    return true;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct BenchResult
+{
+    std::string name;
+
+    /* items processed per repetition, the times are per item */
+    std::size_t items = 1;
+    unsigned int repetitions = 0;
+
+    double minNs = 0.0;
+    double medianNs = 0.0;
+    double meanNs = 0.0;
+    double stddevNs = 0.0;
+    double maxNs = 0.0;
+    double itemsPerSecond = 0.0;
+};
+
+struct Bench
+{
+    /* untimed runs before and timed runs of every benchmark */
+    unsigned int warmup = 3;
+    unsigned int repetitions = 20;
+
+    /* only benchmarks whose name contains the filter are run */
+    std::string filter;
+
+    std::vector<BenchResult> results;
+};
+
+namespace detail
+{
+
+bool benchSelected(const Bench& bench, const std::string& name);
+
+/* computes the statistics of the samples and prints them */
+void benchAddResult(Bench& bench, const std::string& name, std::size_t items, std::vector<double> samplesNs);
+
+}
+
+/**
+ * @brief Keeps the compiler from optimizing away a value that is computed but never used.
+ *
+ * @param value Result of the benchmarked code.
+ */
+template<typename T>
+inline void benchKeep(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * @brief Runs fn warmup times, then times it for every repetition and stores the statistics of the time per item.
+ *
+ * @param bench Benchmark run.
+ * @param name Name of the benchmark, grouped by prefix (e.g. "math/...").
+ * @param items Number of items fn processes per call, e.g. the length of the array it transforms.
+ * @param fn Code to benchmark.
+ */
+template<typename Fn>
+void benchRun(Bench& bench, const std::string& name, std::size_t items, Fn fn)
+{
+    if(!detail::benchSelected(bench, name))
+    {
+        return;
+    }
+
+    for(unsigned int i = 0; i < bench.warmup; i++)
+    {
+        fn();
+    }
+
+    std::vector<double> samples;
+    samples.reserve(bench.repetitions);
+    for(unsigned int i = 0; i < bench.repetitions; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+
+    detail::benchAddResult(bench, name, items, std::move(samples));
+}
+
+/**
+ * @brief Writes the results as JSON.
+ *
+ * @param bench Finished benchmark run.
+ * @param path Path of the report.
+ *
+ * @return False if the report could not be written.
+ */
+bool benchWriteReport(const Bench& bench, const std::string& path);
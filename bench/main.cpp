@@ -0,0 +1,325 @@
+#include "bench.h"
+
+#include "helicopter.h"
+#include "scenegraph.h"
+#include "math/batch.h"
+#include "mygl/camera.h"
+#include "mygl/model.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+namespace detail
+{
+
+/* elements per call of the math benchmarks, small enough to stay in cache */
+constexpr std::size_t BENCH_MATH_COUNT = 4096;
+
+/* elements per call of the batch benchmarks, large enough to be split across threads */
+constexpr std::size_t BENCH_BATCH_COUNT = std::size_t(1) << 20;
+
+/* fixed seed, every run benchmarks the same inputs */
+std::vector<float> benchRandom(std::size_t count, float min, float max)
+{
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<float> distribution(min, max);
+
+    std::vector<float> values(count);
+    for(auto& value : values)
+    {
+        value = distribution(engine);
+    }
+    return values;
+}
+
+std::vector<Matrix4D> benchTransformations(std::size_t count)
+{
+    std::vector<float> values = benchRandom(7 * count, -2.0f, 2.0f);
+
+    std::vector<Matrix4D> transformations(count);
+    for(std::size_t i = 0; i < count; i++)
+    {
+        const float* v = &values[7 * i];
+        transformations[i] = Matrix4D::translation(Vector3D(v[0], v[1], v[2])) *
+                             Matrix4D::rotation(v[3], normalize(Vector3D(v[4], v[5], v[6]) + Vector3D(0, 0, 3))) *
+                             Matrix4D::scale(1.5f, 0.5f, 2.0f);
+    }
+    return transformations;
+}
+
+void benchMath(Bench& bench)
+{
+    std::vector<Matrix4D> A = benchTransformations(BENCH_MATH_COUNT);
+    std::vector<Matrix4D> B(A.rbegin(), A.rend());
+    std::vector<Matrix4D> M(BENCH_MATH_COUNT);
+    std::vector<Affine3D> affineA(A.begin(), A.end());
+    std::vector<Affine3D> affineB(B.begin(), B.end());
+    std::vector<Affine3D> affine(BENCH_MATH_COUNT);
+    std::vector<Matrix3D> normals(BENCH_MATH_COUNT);
+
+    std::vector<float> values = benchRandom(6 * BENCH_MATH_COUNT, -10.0f, 10.0f);
+    std::vector<Vector3D> u(BENCH_MATH_COUNT), v(BENCH_MATH_COUNT), w(BENCH_MATH_COUNT);
+    std::vector<Vector4D> p(BENCH_MATH_COUNT), q(BENCH_MATH_COUNT);
+    for(std::size_t i = 0; i < BENCH_MATH_COUNT; i++)
+    {
+        u[i] = Vector3D(values[6 * i + 0], values[6 * i + 1], values[6 * i + 2]);
+        v[i] = Vector3D(values[6 * i + 3], values[6 * i + 4], values[6 * i + 5]);
+        p[i] = Vector4D(u[i], 1.0f);
+    }
+
+    benchRun(bench, "math/Matrix4D*Matrix4D", BENCH_MATH_COUNT, [&]()
+    {
+        for(std::size_t i = 0; i < BENCH_MATH_COUNT; i++) M[i] = A[i] * B[i];
+        benchKeep(M);
+    });
+
+    benchRun(bench, "math/Matrix4D*Vector4D", BENCH_MATH_COUNT, [&]()
+    {
+        for(std::size_t i = 0; i < BENCH_MATH_COUNT; i++) q[i] = A[i] * p[i];
+        benchKeep(q);
+    });
+
+    benchRun(bench, "math/inverse(Matrix4D)", BENCH_MATH_COUNT, [&]()
+    {
+        for(std::size_t i = 0; i < BENCH_MATH_COUNT; i++) M[i] = inverse(A[i]);
+        benchKeep(M);
+    });
+
+    benchRun(bench, "math/normalMatrix(Matrix4D)", BENCH_MATH_COUNT, [&]()
+    {
+        for(std::size_t i = 0; i < BENCH_MATH_COUNT; i++) normals[i] = normalMatrix(A[i]);
+        benchKeep(normals);
+    });
+
+    benchRun(bench, "math/Affine3D*Affine3D", BENCH_MATH_COUNT, [&]()
+    {
+        for(std::size_t i = 0; i < BENCH_MATH_COUNT; i++) affine[i] = affineA[i] * affineB[i];
+        benchKeep(affine);
+    });
+
+    benchRun(bench, "math/inverse(Affine3D)", BENCH_MATH_COUNT, [&]()
+    {
+        for(std::size_t i = 0; i < BENCH_MATH_COUNT; i++) affine[i] = inverse(affineA[i]);
+        benchKeep(affine);
+    });
+
+    benchRun(bench, "math/cross(Vector3D)", BENCH_MATH_COUNT, [&]()
+    {
+        for(std::size_t i = 0; i < BENCH_MATH_COUNT; i++) w[i] = cross(u[i], v[i]);
+        benchKeep(w);
+    });
+
+    benchRun(bench, "math/normalize(Vector3D)", BENCH_MATH_COUNT, [&]()
+    {
+        for(std::size_t i = 0; i < BENCH_MATH_COUNT; i++) w[i] = normalize(u[i]);
+        benchKeep(w);
+    });
+}
+
+void benchBatch(Bench& bench)
+{
+    const Matrix4D T = benchTransformations(1)[0];
+
+    std::vector<float> values = benchRandom(3 * BENCH_BATCH_COUNT, -100.0f, 100.0f);
+    std::vector<float> result(3 * BENCH_BATCH_COUNT);
+    Vector3DArrays in = {&values[0], &values[BENCH_BATCH_COUNT], &values[2 * BENCH_BATCH_COUNT]};
+    Vector3DArrays out = {&result[0], &result[BENCH_BATCH_COUNT], &result[2 * BENCH_BATCH_COUNT]};
+
+    benchRun(bench, "batch/batchTransformPoints", BENCH_BATCH_COUNT, [&]()
+    {
+        batchTransformPoints(T, in, out, BENCH_BATCH_COUNT);
+        benchKeep(result);
+    });
+
+    /* boxes are the points grown by one in every direction */
+    std::vector<float> boxes(6 * BENCH_BATCH_COUNT);
+    std::vector<float> boxResult(6 * BENCH_BATCH_COUNT);
+    std::transform(values.begin(), values.end(), boxes.begin(), [](float value) { return value - 1.0f; });
+    std::transform(values.begin(), values.end(), boxes.begin() + 3 * BENCH_BATCH_COUNT, [](float value) { return value + 1.0f; });
+    auto arrays = [](std::vector<float>& data) -> AABBArrays
+    {
+        std::size_t n = BENCH_BATCH_COUNT;
+        return {{&data[0], &data[n], &data[2 * n]}, {&data[3 * n], &data[4 * n], &data[5 * n]}};
+    };
+
+    benchRun(bench, "batch/batchTransformAABBs", BENCH_BATCH_COUNT, [&]()
+    {
+        batchTransformAABBs(T, arrays(boxes), arrays(boxResult), BENCH_BATCH_COUNT);
+        benchKeep(boxResult);
+    });
+
+    std::vector<Matrix4D> A = benchTransformations(BENCH_MATH_COUNT);
+    std::vector<Matrix4D> B(A.rbegin(), A.rend());
+    std::vector<Matrix4D> M(BENCH_MATH_COUNT);
+    benchRun(bench, "batch/batchMultiply", BENCH_MATH_COUNT, [&]()
+    {
+        batchMultiply(A.data(), B.data(), M.data(), BENCH_MATH_COUNT);
+        benchKeep(M);
+    });
+}
+
+void benchSceneGraph(Bench& bench)
+{
+    /* ten roots, every other node has a random earlier node as parent */
+    constexpr unsigned int nodes = 10000;
+    std::vector<Affine3D> locals;
+    for(const auto& M : benchTransformations(nodes))
+    {
+        locals.push_back(Affine3D(M));
+    }
+
+    SceneGraph graph;
+    std::mt19937 engine(42);
+    for(unsigned int node = 0; node < nodes; node++)
+    {
+        unsigned int parent = node < 10 ? SceneGraph::NO_PARENT : std::uniform_int_distribution<unsigned int>(0, node - 1)(engine);
+        sceneGraphAdd(graph, parent, locals[node]);
+    }
+    sceneGraphUpdate(graph);
+
+    benchRun(bench, "scenegraph/sceneGraphUpdate/all", nodes, [&]()
+    {
+        for(unsigned int node = 0; node < nodes; node++)
+        {
+            sceneGraphSetLocal(graph, node, locals[node]);
+        }
+        sceneGraphUpdate(graph);
+        benchKeep(graph.worlds);
+    });
+
+    benchRun(bench, "scenegraph/sceneGraphUpdate/last", 1, [&]()
+    {
+        sceneGraphSetLocal(graph, nodes - 1, locals[nodes - 1]);
+        sceneGraphUpdate(graph);
+        benchKeep(graph.worlds);
+    });
+}
+
+void benchLoaders(Bench& bench, const std::string& assets)
+{
+    /* file reading is part of the measurement, after the warmup the files are in the page cache */
+    for(const char* name : {"heli_low_poly/helicopter", "ground/ground"})
+    {
+        std::string path = assets + "/" + name;
+        std::string file = path.substr(path.find_last_of('/') + 1);
+
+        benchRun(bench, "loaders/materialLoad/" + file, 1, [&]()
+        {
+            auto materials = materialLoad(path + ".mtl");
+            benchKeep(materials);
+        });
+
+        benchRun(bench, "loaders/modelParse/" + file, 1, [&]()
+        {
+            ModelFile parsed = modelParse(path + ".obj");
+            benchKeep(parsed);
+        });
+    }
+}
+
+void benchSimulation(Bench& bench)
+{
+    /* simulation steps with all controls held down, every branch of the update is taken */
+    constexpr unsigned int steps = 1000;
+    bool control[Helicopter::eControl::CONTROL_COUNT];
+    std::fill(std::begin(control), std::end(control), true);
+    control[Helicopter::eControl::THROTTLE_DOWN] = false;
+
+    Helicopter heli = helicopterCreate();
+    benchRun(bench, "simulation/helicopterMove", steps, [&]()
+    {
+        for(unsigned int i = 0; i < steps; i++)
+        {
+            helicopterMove(heli, control, 1.0f / 60.0f);
+        }
+        benchKeep(heli);
+    });
+
+    benchRun(bench, "simulation/helicopterInterpolate", steps, [&]()
+    {
+        for(unsigned int i = 0; i < steps; i++)
+        {
+            helicopterInterpolate(heli, i / float(steps));
+        }
+        benchKeep(heli);
+    });
+
+    Camera camera = cameraCreate(1280, 720, to_radians(45.0f), 0.01f, 500.0f, {10.0f, 10.0f, 10.0f}, {0.0f, 0.0f, 0.0f});
+    Matrix4D M;
+    benchRun(bench, "simulation/cameraView", steps, [&]()
+    {
+        for(unsigned int i = 0; i < steps; i++)
+        {
+            camera.position.x = 10.0f + i * 0.001f;
+            M = cameraView(camera);
+            benchKeep(M);
+        }
+    });
+
+    benchRun(bench, "simulation/cameraProjection", steps, [&]()
+    {
+        for(unsigned int i = 0; i < steps; i++)
+        {
+            camera.fov = to_radians(45.0f) + i * 1e-6f;
+            M = cameraProjection(camera);
+            benchKeep(M);
+        }
+    });
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    /* microbenchmarks of the cpu side, without window or OpenGL context
+     * [--warmup N] [--repetitions N] [--filter STR] [--report PATH] [--assets DIR] */
+    Bench bench;
+    std::string report = "bench.json";
+    std::string assets = "assets";
+    for(int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if(std::strcmp(argv[i], "--warmup") == 0 && hasValue)
+        {
+            bench.warmup = std::max(0, std::atoi(argv[++i]));
+        }
+        else if(std::strcmp(argv[i], "--repetitions") == 0 && hasValue)
+        {
+            bench.repetitions = std::max(1, std::atoi(argv[++i]));
+        }
+        else if(std::strcmp(argv[i], "--filter") == 0 && hasValue)
+        {
+            bench.filter = argv[++i];
+        }
+        else if(std::strcmp(argv[i], "--report") == 0 && hasValue)
+        {
+            report = argv[++i];
+        }
+        else if(std::strcmp(argv[i], "--assets") == 0 && hasValue)
+        {
+            assets = argv[++i];
+        }
+        else
+        {
+            std::cerr << "unknown argument " << argv[i] << std::endl;
+        }
+    }
+
+    std::cout << "[Bench] " << bench.warmup << " warmup runs, " << bench.repetitions << " repetitions, time per item" << std::endl;
+
+    detail::benchMath(bench);
+    detail::benchBatch(bench);
+    detail::benchSceneGraph(bench);
+    detail::benchLoaders(bench, assets);
+    detail::benchSimulation(bench);
+
+    if(!report.empty())
+    {
+        benchWriteReport(bench, report);
+    }
+
+    return 0;
+}
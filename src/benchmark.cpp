@@ -0,0 +1,270 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace detail
+{
+
+struct BenchmarkSegment
+{
+    float seconds;
+    std::vector<Helicopter::eControl> controls;
+};
+
+/* take off, fly a wide left turn over the ground and sink back, repeated for the length of the run */
+const std::vector<BenchmarkSegment> BENCHMARK_FLIGHT =
+{
+    {2.0f, {Helicopter::THROTTLE_UP}},
+    {1.5f, {Helicopter::PITCH_DOWN}},
+    {6.0f, {Helicopter::PITCH_DOWN, Helicopter::YAW_LEFT}},
+    {1.0f, {Helicopter::ROLL_RIGHT}},
+    {1.5f, {Helicopter::THROTTLE_DOWN}},
+};
+
+/* the camera circles the helicopter once per orbit period while slowly bobbing up and down and zooming in and out */
+constexpr float BENCHMARK_ORBIT_PERIOD = 20.0f;
+constexpr float BENCHMARK_BOB_PERIOD = 15.0f;
+constexpr float BENCHMARK_BOB_AMPLITUDE = 0.3f;
+constexpr float BENCHMARK_ZOOM_AMPLITUDE = 0.2f;
+
+struct BenchmarkStats
+{
+    float min = 0.0f;
+    float avg = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+    unsigned int samples = 0;
+};
+
+BenchmarkStats benchmarkStats(std::vector<float> values)
+{
+    BenchmarkStats stats;
+    values.erase(std::remove_if(values.begin(), values.end(), [](float v) { return v < 0.0f; }), values.end());
+    if(values.empty())
+    {
+        return stats;
+    }
+
+    std::sort(values.begin(), values.end());
+
+    double sum = 0.0;
+    for(float v : values)
+    {
+        sum += v;
+    }
+
+    stats.samples = values.size();
+    stats.min = values.front();
+    stats.avg = sum / values.size();
+    stats.p99 = values[std::ceil(0.99f * values.size()) - 1];
+    stats.max = values.back();
+    return stats;
+}
+
+/* one column per measured quantity, negative entries mark frames without a measurement */
+struct BenchmarkColumn
+{
+    std::string name;
+    std::vector<float> values;
+};
+
+std::vector<BenchmarkColumn> benchmarkColumns(const Benchmark& bench, const GpuProfiler& profiler)
+{
+    std::vector<BenchmarkColumn> columns(3);
+    columns[0].name = "cpuUpdateMs";
+    columns[1].name = "cpuDrawMs";
+    columns[2].name = "cpuFrameMs";
+    for(auto& frame : bench.results)
+    {
+        columns[0].values.push_back(frame.cpuUpdateMs);
+        columns[1].values.push_back(frame.cpuDrawMs);
+        columns[2].values.push_back(frame.cpuFrameMs);
+    }
+
+    for(auto& pass : profiler.passes)
+    {
+        std::string name = pass.name;
+        name[0] = std::toupper(name[0]);
+        columns.push_back({"gpu" + name + "Ms", std::vector<float>(bench.results.size(), -1.0f)});
+    }
+
+    for(auto& record : profiler.records)
+    {
+        if(record.frame >= bench.results.size())
+        {
+            continue;
+        }
+
+        for(unsigned int i = 0; i < record.ms.size(); i++)
+        {
+            columns[3 + i].values[record.frame] = record.ms[i];
+        }
+    }
+
+    return columns;
+}
+
+std::string benchmarkGlString(GLenum name)
+{
+    const GLubyte* str = glGetString(name);
+    return str ? reinterpret_cast<const char*>(str) : "unknown";
+}
+
+void benchmarkWriteJson(std::ofstream& file, const Benchmark& bench, const std::vector<BenchmarkColumn>& columns)
+{
+    file << "{\n";
+    file << "  \"renderer\": \"" << benchmarkGlString(GL_RENDERER) << "\",\n";
+    file << "  \"version\": \"" << benchmarkGlString(GL_VERSION) << "\",\n";
+    file << "  \"width\": " << bench.width << ",\n";
+    file << "  \"height\": " << bench.height << ",\n";
+    file << "  \"frames\": " << bench.results.size() << ",\n";
+    file << "  \"timestep\": " << bench.timestep << ",\n";
+
+    file << "  \"summary\": {\n";
+    for(unsigned int c = 0; c < columns.size(); c++)
+    {
+        BenchmarkStats stats = benchmarkStats(columns[c].values);
+        file << "    \"" << columns[c].name << "\": {\"min\": " << stats.min << ", \"avg\": " << stats.avg << ", \"p99\": " << stats.p99
+             << ", \"max\": " << stats.max << ", \"samples\": " << stats.samples << "}" << (c + 1 < columns.size() ? "," : "") << "\n";
+    }
+    file << "  },\n";
+
+    file << "  \"perFrame\": [\n";
+    for(unsigned int f = 0; f < bench.results.size(); f++)
+    {
+        file << "    {\"frame\": " << f;
+        for(auto& column : columns)
+        {
+            /* json has no NaN, missing gpu results are written as null */
+            file << ", \"" << column.name << "\": ";
+            if(column.values[f] < 0.0f) file << "null";
+            else file << column.values[f];
+        }
+        file << "}" << (f + 1 < bench.results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n";
+    file << "}\n";
+}
+
+void benchmarkWriteCsv(std::ofstream& file, const Benchmark& bench, const std::vector<BenchmarkColumn>& columns)
+{
+    file << "frame";
+    for(auto& column : columns)
+    {
+        file << "," << column.name;
+    }
+    file << "\n";
+
+    for(unsigned int f = 0; f < bench.results.size(); f++)
+    {
+        file << f;
+        for(auto& column : columns)
+        {
+            file << ",";
+            if(column.values[f] >= 0.0f) file << column.values[f];
+        }
+        file << "\n";
+    }
+}
+
+}
+
+Benchmark benchmarkCreate(unsigned int frames, float timestep, const std::string& reportPath, unsigned int width, unsigned int height)
+{
+    assert(frames > 0 && timestep > 0.0f && width != 0 && height != 0);
+
+    Benchmark bench;
+    bench.frames = frames;
+    bench.timestep = timestep;
+    bench.reportPath = reportPath;
+    bench.width = width;
+    bench.height = height;
+    bench.results.reserve(frames);
+
+    return bench;
+}
+
+bool benchmarkDone(const Benchmark& bench)
+{
+    return bench.frame >= bench.frames;
+}
+
+void benchmarkScript(const Benchmark& bench, bool control[], Camera& cam)
+{
+    /* time is derived from the frame index, so the script does not depend on how long frames take */
+    float t = bench.frame * bench.timestep;
+
+    float loop = 0.0f;
+    for(auto& segment : detail::BENCHMARK_FLIGHT)
+    {
+        loop += segment.seconds;
+    }
+    float local = std::fmod(t, loop);
+
+    std::fill(control, control + Helicopter::CONTROL_COUNT, false);
+    for(auto& segment : detail::BENCHMARK_FLIGHT)
+    {
+        if(local < segment.seconds)
+        {
+            for(auto c : segment.controls)
+            {
+                control[c] = true;
+            }
+            break;
+        }
+        local -= segment.seconds;
+    }
+
+    /* cameraUpdateOrbit takes pixel deltas, convert the angular speeds of this frame accordingly */
+    float dPhi = 2.0f * M_PI * bench.timestep / detail::BENCHMARK_ORBIT_PERIOD;
+    float bob = 2.0f * M_PI / detail::BENCHMARK_BOB_PERIOD;
+    float dTheta = detail::BENCHMARK_BOB_AMPLITUDE * bob * std::cos(bob * t) * bench.timestep;
+    float zoom = detail::BENCHMARK_ZOOM_AMPLITUDE * bob * std::sin(bob * t) * bench.timestep;
+
+    cameraUpdateOrbit(cam, {dPhi * cam.width / float(M_PI), dTheta * cam.height / float(M_PI)}, zoom);
+}
+
+void benchmarkEndFrame(Benchmark& bench, const BenchmarkFrame& frame)
+{
+    bench.results.push_back(frame);
+    bench.frame++;
+}
+
+bool benchmarkWriteReport(const Benchmark& bench, const GpuProfiler& profiler)
+{
+    auto columns = detail::benchmarkColumns(bench, profiler);
+
+    std::ofstream file(bench.reportPath);
+    if(!file)
+    {
+        std::cerr << "[Benchmark] could not open " << bench.reportPath << std::endl;
+        return false;
+    }
+
+    bool csv = bench.reportPath.size() >= 4 && bench.reportPath.compare(bench.reportPath.size() - 4, 4, ".csv") == 0;
+    if(csv)
+    {
+        detail::benchmarkWriteCsv(file, bench, columns);
+    }
+    else
+    {
+        detail::benchmarkWriteJson(file, bench, columns);
+    }
+
+    std::cout << "[Benchmark] " << bench.results.size() << " frames at " << bench.width << "x" << bench.height << " written to " << bench.reportPath << std::endl;
+    for(auto& column : columns)
+    {
+        auto stats = detail::benchmarkStats(column.values);
+        std::cout << "    " << std::left << std::setw(16) << column.name << std::right << std::fixed << std::setprecision(3)
+                  << " min " << stats.min << " ms, avg " << stats.avg << " ms, p99 " << stats.p99 << " ms, max " << stats.max << " ms" << std::endl;
+        std::cout << std::defaultfloat;
+    }
+
+    return bool(file);
+}
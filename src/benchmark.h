@@ -0,0 +1,90 @@
+#pragma once
+
+#include "mygl/base.h"
+#include "mygl/camera.h"
+#include "mygl/gpuprofiler.h"
+
+#include "helicopter.h"
+
+#include <string>
+#include <vector>
+
+struct BenchmarkFrame
+{
+    /* cpu time in milliseconds of the simulation step, of issuing the draw calls and of the whole frame */
+    float cpuUpdateMs = 0.0f;
+    float cpuDrawMs = 0.0f;
+    float cpuFrameMs = 0.0f;
+};
+
+struct Benchmark
+{
+    /* number of rendered frames and simulated seconds per frame, independent of how long a frame actually takes */
+    unsigned int frames = 600;
+    float timestep = 1.0f / 60.0f;
+
+    /* report is written as csv if the path ends in .csv, as json otherwise */
+    std::string reportPath = "benchmark.json";
+
+    /* the last frame is saved as png if not empty */
+    std::string screenshotPath;
+
+    /* every frame is recorded to this y4m file or png sequence if not empty */
+    std::string capturePath;
+
+    unsigned int width = 1280;
+    unsigned int height = 720;
+
+    unsigned int frame = 0;
+    std::vector<BenchmarkFrame> results;
+};
+
+/**
+ * @brief Creates a benchmark run. The scene is driven by a fixed script, so every run renders the same frames.
+ *
+ * @param frames Number of frames to render.
+ * @param timestep Simulated time per frame in seconds.
+ * @param reportPath Path of the json or csv report.
+ * @param width Width of the offscreen render target.
+ * @param height Height of the offscreen render target.
+ *
+ * @return Initialized benchmark.
+ */
+Benchmark benchmarkCreate(unsigned int frames, float timestep, const std::string& reportPath, unsigned int width, unsigned int height);
+
+/**
+ * @brief Checks whether all frames of the benchmark were rendered.
+ *
+ * @param bench Benchmark.
+ *
+ * @return True once benchmarkEndFrame was called for every frame.
+ */
+bool benchmarkDone(const Benchmark& bench);
+
+/**
+ * @brief Sets the scripted helicopter controls and camera for the current frame.
+ *
+ * @param bench Benchmark.
+ * @param control Helicopter controls, indexed by Helicopter::eControl.
+ * @param cam Camera that orbits the helicopter along the scripted path.
+ */
+void benchmarkScript(const Benchmark& bench, bool control[], Camera& cam);
+
+/**
+ * @brief Stores the cpu timings of the current frame and advances to the next one.
+ *
+ * @param bench Benchmark.
+ * @param frame Cpu timings of the frame.
+ */
+void benchmarkEndFrame(Benchmark& bench, const BenchmarkFrame& frame);
+
+/**
+ * @brief Writes the per frame cpu and gpu timings and their statistics to the report path. The gpu profiler has to be
+ * created with record enabled and flushed before.
+ *
+ * @param bench Finished benchmark.
+ * @param profiler Gpu profiler that measured the frames.
+ *
+ * @return False if the report could not be written.
+ */
+bool benchmarkWriteReport(const Benchmark& bench, const GpuProfiler& profiler);
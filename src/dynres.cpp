@@ -0,0 +1,88 @@
+#include "dynres.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+namespace detail
+{
+
+/* measurements are tagged with the scale in steps, so results of frames rendered before a change can be ignored */
+int dynresTag(const DynamicResolution& dr)
+{
+    return std::lround(dr.scale / dr.step);
+}
+
+float dynresQuantize(const DynamicResolution& dr, float scale)
+{
+    scale = std::round(scale / dr.step) * dr.step;
+    return std::clamp(scale, dr.minScale, dr.maxScale);
+}
+
+}
+
+DynamicResolution dynresCreate(float minScale, float maxScale, float budgetMs)
+{
+    assert(minScale > 0.0f && minScale <= maxScale && budgetMs > 0.0f);
+
+    DynamicResolution dr;
+    dr.minScale = minScale;
+    dr.maxScale = maxScale;
+    dr.budgetMs = budgetMs;
+    dr.scale = maxScale;
+
+    return dr;
+}
+
+void dynresSize(const DynamicResolution& dr, unsigned int windowWidth, unsigned int windowHeight, unsigned int& width, unsigned int& height)
+{
+    width = std::max(1l, std::lround(windowWidth * dr.scale));
+    height = std::max(1l, std::lround(windowHeight * dr.scale));
+}
+
+void dynresUpdate(DynamicResolution& dr, const GpuProfiler& profiler)
+{
+    /* the frame that just ended was drawn at the current scale */
+    dr.tags[(profiler.frame - 1) % DynamicResolution::TAG_COUNT] = detail::dynresTag(dr);
+
+    float ms = 0.0f;
+    unsigned int frame = 0;
+    bool measured = gpuProfilerLatest(profiler, "frame", ms, frame) && frame != dr.measuredFrame &&
+                    profiler.frame - frame <= DynamicResolution::TAG_COUNT &&
+                    dr.tags[frame % DynamicResolution::TAG_COUNT] == detail::dynresTag(dr);
+    if(measured)
+    {
+        dr.measuredFrame = frame;
+        dr.frameMs = ms;
+    }
+
+    if(measured && dr.enabled && (ms > dr.budgetMs || ms < dr.headroom * dr.budgetMs))
+    {
+        /* the cost is roughly proportional to the pixel count, aim for the middle between headroom and budget */
+        float target = 0.5f * (1.0f + dr.headroom) * dr.budgetMs;
+        float scale = dr.scale * std::sqrt(target / std::max(ms, 1e-3f));
+
+        /* move at least one step, small corrections would otherwise be rounded away */
+        if(std::fabs(scale - dr.scale) < dr.step)
+        {
+            scale = dr.scale + std::copysign(dr.step, scale - dr.scale);
+        }
+        dr.scale = detail::dynresQuantize(dr, scale);
+    }
+
+    if(dr.log)
+    {
+        std::cout << "[DynRes] frame " << dr.frame << ": scale " << dr.scale << ", GPU " << dr.frameMs << " ms" << std::endl;
+    }
+    dr.frame++;
+}
+
+void dynresSetEnabled(DynamicResolution& dr, bool enabled)
+{
+    dr.enabled = enabled;
+    if(!enabled)
+    {
+        dr.scale = dr.maxScale;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "mygl/base.h"
+#include "mygl/gpuprofiler.h"
+
+struct DynamicResolution
+{
+    /* limits of the render scale (fraction of the window size per axis) and the GPU time one frame may take */
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+    float budgetMs = 16.0f;
+
+    /* the scale only moves in steps of this size, so render targets are not reallocated for every small change */
+    float step = 0.05f;
+
+    /* the scale only changes if the frame takes longer than the budget or less than this fraction of it, otherwise
+     * the scale would oscillate around the budget */
+    float headroom = 0.8f;
+
+    bool enabled = true;
+    bool log = true;
+
+    float scale = 1.0f;
+    float frameMs = 0.0f;
+    unsigned int frame = 0;
+
+    /* scale (in steps) every frame in flight was drawn at, indexed by the profiler frame. Results arrive a few frames
+     * late, so results of frames drawn before a change can be told apart and ignored */
+    static constexpr unsigned int TAG_COUNT = 2 * GpuProfiler::FRAME_COUNT;
+    int tags[TAG_COUNT] = {};
+
+    /* profiler frame of the last result that was evaluated */
+    unsigned int measuredFrame = ~0u;
+};
+
+/**
+ * @brief Creates a controller that adapts the render resolution to the GPU time of the previous frames, as measured by
+ * the "frame" pass of the gpu profiler.
+ *
+ * @param minScale Smallest allowed scale of the window size.
+ * @param maxScale Largest allowed scale of the window size.
+ * @param budgetMs GPU time in milliseconds a frame should take.
+ *
+ * @return Initialized controller, starting at the largest scale.
+ */
+DynamicResolution dynresCreate(float minScale, float maxScale, float budgetMs);
+
+/**
+ * @brief Computes the render target size for the current scale.
+ *
+ * @param dr Dynamic resolution controller.
+ * @param windowWidth Width of the window (backbuffer).
+ * @param windowHeight Height of the window (backbuffer).
+ * @param width Width the scene should be rendered at.
+ * @param height Height the scene should be rendered at.
+ */
+void dynresSize(const DynamicResolution& dr, unsigned int windowWidth, unsigned int windowHeight, unsigned int& width, unsigned int& height);
+
+/**
+ * @brief Picks the scale for the next frames from the newest GPU time of the "frame" pass. Has to be called once per
+ * frame after gpuProfilerEndFrame. Only measurements of frames drawn at the current scale are considered.
+ *
+ * @param dr Dynamic resolution controller.
+ * @param profiler Gpu profiler that measured the frames.
+ */
+void dynresUpdate(DynamicResolution& dr, const GpuProfiler& profiler);
+
+/**
+ * @brief Enables or disables the controller. Disabling it renders at the largest scale.
+ *
+ * @param dr Dynamic resolution controller.
+ * @param enabled Whether the scale follows the GPU time.
+ */
+void dynresSetEnabled(DynamicResolution& dr, bool enabled);
@@ -1,22 +1,66 @@
 #include "helicopter.h"
 
 #include "mygl/geometry.h"
+#include "mygl/cpuprofiler.h"
 
+#include <cmath>
 #include <stdexcept>
 
-Helicopter helicopterLoad(const std::string& filepath)
+namespace detail
 {
-    std::vector<Model> models = modelLoad(filepath);
+
+/* rotor hubs in model space, the rotors spin around axes through them */
+constexpr Vector3D HELICOPTER_ROTOR_PIVOT(0, 0, -0.69129);
+constexpr Vector3D HELICOPTER_TAIL_ROTOR_PIVOT(-0.28062, 1.813, -8.009);
+
+constexpr Affine3D HELICOPTER_ROTOR_TO_PIVOT = Affine3D::translation(HELICOPTER_ROTOR_PIVOT);
+constexpr Affine3D HELICOPTER_ROTOR_FROM_PIVOT = Affine3D::translation(-HELICOPTER_ROTOR_PIVOT);
+constexpr Affine3D HELICOPTER_TAIL_ROTOR_TO_PIVOT = Affine3D::translation(HELICOPTER_TAIL_ROTOR_PIVOT);
+constexpr Affine3D HELICOPTER_TAIL_ROTOR_FROM_PIVOT = Affine3D::translation(-HELICOPTER_TAIL_ROTOR_PIVOT);
+
+static_assert(HELICOPTER_ROTOR_TO_PIVOT * HELICOPTER_ROTOR_FROM_PIVOT == Affine3D::identity());
+static_assert(HELICOPTER_TAIL_ROTOR_TO_PIVOT * HELICOPTER_TAIL_ROTOR_FROM_PIVOT == Affine3D::identity());
+
+void helicopterPose(Helicopter& heli, const Vector3D& position, const Vector3D& angles, float rotorRotation)
+{
+    Affine3D rotation = Affine3D::rotationY(angles.y) * Affine3D::rotationX(angles.x) * Affine3D::rotationZ(angles.z);
+    sceneGraphSetLocal(heli.graph, heli.node, Affine3D::translation(position) * rotation);
+
+    /* animation of rotors, the world transformations are only computed once they are needed */
+    sceneGraphSetLocal(heli.graph, heli.partNodes[Helicopter::ROTOR],
+                       HELICOPTER_ROTOR_TO_PIVOT * Affine3D::rotationY(rotorRotation) * HELICOPTER_ROTOR_FROM_PIVOT);
+    sceneGraphSetLocal(heli.graph, heli.partNodes[Helicopter::TAIL_ROTOR],
+                       HELICOPTER_TAIL_ROTOR_TO_PIVOT * Affine3D::rotationX(rotorRotation) * HELICOPTER_TAIL_ROTOR_FROM_PIVOT);
+}
+
+}
+
+Helicopter helicopterCreate()
+{
+    Helicopter heli;
+    heli.position.y = 5.5f;
+    heli.prevPosition = heli.position;
+
+    heli.node = sceneGraphAdd(heli.graph, SceneGraph::NO_PARENT);
+    for(unsigned int part = 0; part < Helicopter::PART_COUNT; part++)
+    {
+        heli.partNodes[part] = sceneGraphAdd(heli.graph, heli.node);
+    }
+
+    return heli;
+}
+
+Helicopter helicopterLoad(const std::string& filepath, Registry& registry)
+{
+    std::vector<Model> models = modelLoad(filepath, registry);
 
     if(models.size() != Helicopter::PART_COUNT)
     {
         throw std::runtime_error("[Helicopter] number of parts do not match!");
     }
 
-    Helicopter heli;
+    Helicopter heli = helicopterCreate();
     heli.partModel.resize(models.size());
-    heli.partTransformations.resize(Helicopter::ePart::PART_COUNT, Matrix4D::identity());
-    heli.position.y = 5.5f;
 
     /* re-assign models to match enums (just to be safe ;) (order should actually match the one in the obj file)) */
     for(const auto& obj : models)
@@ -35,27 +79,37 @@ Helicopter helicopterLoad(const std::string& filepath)
     return heli;
 }
 
-void helicopterDelete(Helicopter& heli)
+void helicopterDelete(Helicopter& heli, Registry& registry)
 {
     for(auto& model : heli.partModel)
     {
-        modelDelete(model);
+        modelDelete(model, registry);
     }
 
     heli.partModel.clear();
-    heli.partTransformations.clear();
+    heli.graph = SceneGraph();
 }
 
 void helicopterMove(Helicopter& heli, bool control[], float dt)
 {
+    PROFILE_ZONE("helicopterMove");
+
+    heli.prevPosition = heli.position;
+    heli.prevAngles = heli.angles;
+    heli.prevRotorRotation = heli.rotorRotation;
+
     /* retrieve input for controls */
     float throttle = + control[Helicopter::eControl::THROTTLE_UP] - control[Helicopter::eControl::THROTTLE_DOWN];
     float yaw = + control[Helicopter::eControl::YAW_LEFT] - control[Helicopter::eControl::YAW_RIGHT];
     float pitch = + control[Helicopter::eControl::PITCH_DOWN] - control[Helicopter::eControl::PITCH_UP];
     float roll = + control[Helicopter::eControl::ROLL_RIGHT] - control[Helicopter::eControl::ROLL_LEFT];
 
-    auto up = Vector3D(heli.rotation[1]);
-    auto lift = normalize(up) * (throttle * heli.lift);
+    /* up axis of the current orientation, the column 1 of rotationY * rotationX * rotationZ */
+    float sx = std::sin(heli.angles.x), cx = std::cos(heli.angles.x);
+    float sy = std::sin(heli.angles.y), cy = std::cos(heli.angles.y);
+    float sz = std::sin(heli.angles.z), cz = std::cos(heli.angles.z);
+    Vector3D up(sy * sx * cz - cy * sz, cx * cz, sy * sz + cy * sx * cz);
+    auto lift = up * (throttle * heli.lift);
 
     /* compute change in position and angles */
     heli.position += dt * lift + dt * Vector3D(up.x, 0.0f, up.z) * heli.velocity;
@@ -63,14 +117,16 @@ void helicopterMove(Helicopter& heli, bool control[], float dt)
     heli.angles.y += dt * yaw;
     heli.angles.z += dt * roll - dt * heli.angles.z/M_PI_4;
 
-    /* final transformation matrices */
-    heli.rotation = Matrix4D::rotationY(heli.angles.y) * Matrix4D::rotationX(heli.angles.x) * Matrix4D::rotationZ(heli.angles.z);
-    heli.transformation = Matrix4D::translation(heli.position) * heli.rotation;
-
-    /* animation of rotors */
-    /* animation of rotors */
     heli.rotorRotation += dt*0.5*M_PI;
-    #define TRANS_INV(vec, matrix) Matrix4D::translation(vec) * (matrix) * Matrix4D::translation(-vec);
-    heli.partTransformations[Helicopter::ROTOR] = TRANS_INV(Vector4D(0, 0, -0.69129), Matrix4D::rotationY(heli.rotorRotation));
-    heli.partTransformations[Helicopter::TAIL_ROTOR] = TRANS_INV(Vector4D(-0.28062, 1.813, -8.009), Matrix4D::rotationX(heli.rotorRotation));
+}
+
+void helicopterInterpolate(Helicopter& heli, float alpha)
+{
+    /* angles are never wrapped, so component-wise interpolation does not take the long way around */
+    Vector3D position = heli.prevPosition + alpha * (heli.position - heli.prevPosition);
+    Vector3D angles = heli.prevAngles + alpha * (heli.angles - heli.prevAngles);
+    float rotorRotation = heli.prevRotorRotation + alpha * (heli.rotorRotation - heli.prevRotorRotation);
+
+    detail::helicopterPose(heli, position, angles, rotorRotation);
+    sceneGraphUpdate(heli.graph);
 }
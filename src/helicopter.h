@@ -3,6 +3,8 @@
 #include "mygl/base.h"
 #include "mygl/model.h"
 
+#include "scenegraph.h"
+
 #include <vector>
 
 struct Helicopter
@@ -34,21 +36,34 @@ struct Helicopter
     };
 
 
-    std::vector<Matrix4D> partTransformations;
     std::vector<Model> partModel;
 
-    Matrix4D transformation = Matrix4D::identity();
-    Matrix4D rotation = Matrix4D::identity();
+    /* the helicopter is node of graph and its parts are children of it, rotors are animated by their local
+     * transformation */
+    SceneGraph graph;
+    unsigned int node = 0;
+    unsigned int partNodes[PART_COUNT] = {};
 
     Vector3D position = {0.0, 0.0, 0.0};
     Vector3D angles = {0.0, 0.0, 0.0};
 
     float rotorRotation = 0.0f;
 
+    /* state before the last helicopterMove, rendering interpolates between it and the current state */
+    Vector3D prevPosition = {0.0, 0.0, 0.0};
+    Vector3D prevAngles = {0.0, 0.0, 0.0};
+    float prevRotorRotation = 0.0f;
+
     float velocity = 10.0f;
     float lift = 3.0f;
 };
 
-Helicopter helicopterLoad(const std::string& filepath);
-void helicopterDelete(Helicopter& heli);
+/* helicopter at its start position without models, enough to simulate it */
+Helicopter helicopterCreate();
+Helicopter helicopterLoad(const std::string& filepath, Registry& registry);
+void helicopterDelete(Helicopter& heli, Registry& registry);
 void helicopterMove(Helicopter& heli, bool control[], float dt);
+
+/* poses the helicopter at the state alpha of the way from the previous to the current step and updates the world
+ * transformations of its graph */
+void helicopterInterpolate(Helicopter& heli, float alpha);
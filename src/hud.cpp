@@ -0,0 +1,310 @@
+#include "hud.h"
+
+#include "mygl/cpuprofiler.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+
+#define NK_INCLUDE_FIXED_TYPES
+#define NK_INCLUDE_STANDARD_VARARGS
+#define NK_INCLUDE_DEFAULT_ALLOCATOR
+#define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+#define NK_INCLUDE_FONT_BAKING
+#define NK_INCLUDE_DEFAULT_FONT
+#define NK_IMPLEMENTATION
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#pragma GCC diagnostic ignored "-Wdeprecated-enum-enum-conversion"
+#pragma GCC diagnostic ignored "-Wstringop-overflow"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <nuklear.h>
+#pragma GCC diagnostic pop
+
+struct HudContext
+{
+    nk_context ctx;
+    nk_font_atlas atlas;
+    nk_draw_null_texture null;
+    nk_buffer commands;
+};
+
+namespace detail
+{
+
+/* upper limit of the converted command list, the overlay is a single small window */
+constexpr std::size_t HUD_VERTEX_BYTES = 512 * 1024;
+constexpr std::size_t HUD_INDEX_BYTES = 128 * 1024;
+
+struct HudVertex
+{
+    float position[2];
+    float uv[2];
+    nk_byte color[4];
+};
+
+void hudInput(Hud& hud, int width, int height)
+{
+    nk_context* ctx = &hud.context->ctx;
+    nk_input_begin(ctx);
+
+    if(hud.window)
+    {
+        /* nuklear works in framebuffer pixels, glfw reports the cursor in window coordinates */
+        int windowWidth = 0, windowHeight = 0;
+        glfwGetWindowSize(hud.window, &windowWidth, &windowHeight);
+
+        double x = 0.0, y = 0.0;
+        glfwGetCursorPos(hud.window, &x, &y);
+        x *= windowWidth > 0 ? double(width) / windowWidth : 1.0;
+        y *= windowHeight > 0 ? double(height) / windowHeight : 1.0;
+
+        nk_input_motion(ctx, int(x), int(y));
+        nk_input_button(ctx, NK_BUTTON_LEFT, int(x), int(y), glfwGetMouseButton(hud.window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS);
+    }
+
+    nk_input_end(ctx);
+}
+
+void hudLayout(Hud& hud, const HudStats& stats, const GpuProfiler& profiler, const GBuffer& gb, SSR& ssr)
+{
+    nk_context* ctx = &hud.context->ctx;
+
+    const nk_flags flags = NK_WINDOW_BORDER | NK_WINDOW_MOVABLE | NK_WINDOW_SCALABLE | NK_WINDOW_MINIMIZABLE | NK_WINDOW_TITLE;
+    if(nk_begin(ctx, "Performance", nk_rect(10, 10, 330, 600), flags))
+    {
+        unsigned int last = (hud.next + Hud::HISTORY - 1) % Hud::HISTORY;
+
+        nk_layout_row_dynamic(ctx, 18, 1);
+        nk_labelf(ctx, NK_TEXT_LEFT, "frame: CPU %.2f ms, GPU %.2f ms (%.0f fps)", hud.cpuFrameMs[last], hud.gpuFrameMs[last],
+                  hud.cpuFrameMs[last] > 0.0f ? 1000.0f / hud.cpuFrameMs[last] : 0.0f);
+
+        /* frame time graph, cpu and gpu share the scale */
+        float maxMs = 1.0f;
+        for(unsigned int i = 0; i < Hud::HISTORY; i++)
+        {
+            maxMs = std::max({maxMs, hud.cpuFrameMs[i], hud.gpuFrameMs[i]});
+        }
+
+        nk_layout_row_dynamic(ctx, 80, 1);
+        if(nk_chart_begin_colored(ctx, NK_CHART_LINES, nk_rgb(255, 200, 0), nk_rgb(255, 255, 255), Hud::HISTORY, 0.0f, maxMs))
+        {
+            nk_chart_add_slot_colored(ctx, NK_CHART_LINES, nk_rgb(0, 200, 255), nk_rgb(255, 255, 255), Hud::HISTORY, 0.0f, maxMs);
+            for(unsigned int i = 0; i < Hud::HISTORY; i++)
+            {
+                nk_chart_push_slot(ctx, hud.cpuFrameMs[(hud.next + i) % Hud::HISTORY], 0);
+                nk_chart_push_slot(ctx, hud.gpuFrameMs[(hud.next + i) % Hud::HISTORY], 1);
+            }
+            nk_chart_end(ctx);
+        }
+        nk_layout_row_dynamic(ctx, 18, 1);
+        nk_labelf(ctx, NK_TEXT_LEFT, "graph: CPU (yellow), GPU (blue), 0 - %.1f ms", maxMs);
+
+        /* gpu passes, rolling statistics of the profiler */
+        nk_label(ctx, "GPU passes (avg / p99):", NK_TEXT_LEFT);
+        nk_layout_row_dynamic(ctx, 18, 2);
+        for(const auto& pass : profiler.passes)
+        {
+            GpuProfilerStats gpu = gpuProfilerStats(profiler, pass.name);
+            nk_label(ctx, pass.name.c_str(), NK_TEXT_LEFT);
+            nk_labelf(ctx, NK_TEXT_RIGHT, "%.3f / %.3f ms", gpu.avg, gpu.p99);
+        }
+
+        nk_layout_row_dynamic(ctx, 18, 1);
+        nk_label(ctx, "CPU (last frame):", NK_TEXT_LEFT);
+        nk_layout_row_dynamic(ctx, 18, 2);
+        nk_label(ctx, "update", NK_TEXT_LEFT);
+        nk_labelf(ctx, NK_TEXT_RIGHT, "%.3f ms", stats.cpuUpdateMs);
+        nk_label(ctx, "draw", NK_TEXT_LEFT);
+        nk_labelf(ctx, NK_TEXT_RIGHT, "%.3f ms", stats.cpuDrawMs);
+        nk_label(ctx, "hud", NK_TEXT_LEFT);
+        nk_labelf(ctx, NK_TEXT_RIGHT, "%.3f ms", stats.cpuHudMs);
+
+        nk_label(ctx, "draw calls", NK_TEXT_LEFT);
+        nk_labelf(ctx, NK_TEXT_RIGHT, "%u", stats.drawCalls + ssr.drawCalls);
+        nk_label(ctx, "triangles", NK_TEXT_LEFT);
+        nk_labelf(ctx, NK_TEXT_RIGHT, "%u", stats.triangles);
+        nk_labelf(ctx, NK_TEXT_LEFT, "gBuffer %ux%u", gb.width, gb.height);
+        nk_labelf(ctx, NK_TEXT_RIGHT, "%.1f MiB", gbufferMemory(gb) / (1024.0f * 1024.0f));
+        nk_label(ctx, "SSR targets", NK_TEXT_LEFT);
+        nk_labelf(ctx, NK_TEXT_RIGHT, "%.1f MiB", ssrMemory(ssr) / (1024.0f * 1024.0f));
+
+        nk_layout_row_dynamic(ctx, 18, 1);
+
+        /* trace parameters are uniforms, changes apply in the next frame */
+        nk_label(ctx, "SSR:", NK_TEXT_LEFT);
+        nk_layout_row_dynamic(ctx, 22, 1);
+        nk_property_int(ctx, "steps", 1, &ssr.steps, 64, 1, 0.2f);
+        nk_property_float(ctx, "max distance", 1.0f, &ssr.maxDistance, 50.0f, 0.5f, 0.05f);
+        nk_property_float(ctx, "thickness", 0.01f, &ssr.thickness, 2.0f, 0.01f, 0.005f);
+    }
+    nk_end(ctx);
+}
+
+void hudRender(Hud& hud, int width, int height)
+{
+    HudContext& context = *hud.context;
+
+    static const nk_draw_vertex_layout_element layout[] =
+    {
+        {NK_VERTEX_POSITION, NK_FORMAT_FLOAT, offsetof(HudVertex, position)},
+        {NK_VERTEX_TEXCOORD, NK_FORMAT_FLOAT, offsetof(HudVertex, uv)},
+        {NK_VERTEX_COLOR, NK_FORMAT_R8G8B8A8, offsetof(HudVertex, color)},
+        {NK_VERTEX_LAYOUT_END}
+    };
+
+    nk_convert_config config = {};
+    config.vertex_layout = layout;
+    config.vertex_size = sizeof(HudVertex);
+    config.vertex_alignment = alignof(HudVertex);
+    config.null = context.null;
+    config.circle_segment_count = 22;
+    config.curve_segment_count = 22;
+    config.arc_segment_count = 22;
+    config.global_alpha = 1.0f;
+    config.shape_AA = NK_ANTI_ALIASING_ON;
+    config.line_AA = NK_ANTI_ALIASING_ON;
+
+    /* convert the command list straight into the mapped buffers */
+    glBindVertexArray(hud.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, hud.vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, hud.ebo);
+    glBufferData(GL_ARRAY_BUFFER, HUD_VERTEX_BYTES, NULL, GL_STREAM_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, HUD_INDEX_BYTES, NULL, GL_STREAM_DRAW);
+
+    void* vertices = glMapBufferRange(GL_ARRAY_BUFFER, 0, HUD_VERTEX_BYTES, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    void* indices = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, HUD_INDEX_BYTES, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    {
+        nk_buffer vbuf, ebuf;
+        nk_buffer_init_fixed(&vbuf, vertices, HUD_VERTEX_BYTES);
+        nk_buffer_init_fixed(&ebuf, indices, HUD_INDEX_BYTES);
+        nk_convert(&context.ctx, &context.commands, &vbuf, &ebuf, &config);
+    }
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+
+    glEnable(GL_BLEND);
+    glBlendEquation(GL_FUNC_ADD);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_SCISSOR_TEST);
+
+    glUseProgram(hud.shader.id);
+    shaderUniform(hud.shader, "uProj", Matrix4D::ortho(0.0f, height, width, 0.0f, -1.0f, 1.0f));
+    glActiveTexture(GL_TEXTURE0);
+
+    const nk_draw_command* cmd = nullptr;
+    const nk_draw_index* offset = nullptr;
+    nk_draw_foreach(cmd, &context.ctx, &context.commands)
+    {
+        if(!cmd->elem_count)
+        {
+            continue;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, cmd->texture.id);
+        glScissor(GLint(cmd->clip_rect.x), GLint(height - (cmd->clip_rect.y + cmd->clip_rect.h)),
+                  GLint(cmd->clip_rect.w), GLint(cmd->clip_rect.h));
+        glDrawElements(GL_TRIANGLES, cmd->elem_count, GL_UNSIGNED_SHORT, offset);
+        offset += cmd->elem_count;
+    }
+
+    nk_clear(&context.ctx);
+    nk_buffer_clear(&context.commands);
+
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_BLEND);
+    glBindVertexArray(0);
+}
+
+}
+
+Hud hudCreate(GLFWwindow* window)
+{
+    Hud hud;
+    hud.window = window;
+    hud.context = new HudContext();
+    hud.shader = shaderLoad("shader/hud.vert", "shader/hud.frag");
+
+    glGenVertexArrays(1, &hud.vao);
+    glGenBuffers(1, &hud.vbo);
+    glGenBuffers(1, &hud.ebo);
+
+    glBindVertexArray(hud.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, hud.vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, hud.ebo);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(detail::HudVertex), (void*) offsetof(detail::HudVertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(detail::HudVertex), (void*) offsetof(detail::HudVertex, uv));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(detail::HudVertex), (void*) offsetof(detail::HudVertex, color));
+    glBindVertexArray(0);
+
+    /* bake nuklear's default font into a texture */
+    nk_font_atlas* atlas = &hud.context->atlas;
+    nk_font_atlas_init_default(atlas);
+    nk_font_atlas_begin(atlas);
+    nk_font* font = nk_font_atlas_add_default(atlas, 13.0f, NULL);
+
+    int width = 0, height = 0;
+    const void* image = nk_font_atlas_bake(atlas, &width, &height, NK_FONT_ATLAS_RGBA32);
+
+    glGenTextures(1, &hud.font);
+    glBindTexture(GL_TEXTURE_2D, hud.font);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    nk_font_atlas_end(atlas, nk_handle_id(int(hud.font)), &hud.context->null);
+    nk_init_default(&hud.context->ctx, &font->handle);
+    nk_buffer_init_default(&hud.context->commands);
+    glCheckError();
+
+    return hud;
+}
+
+bool hudHovered(const Hud& hud)
+{
+    return hud.visible && hud.context && nk_window_is_any_hovered(&hud.context->ctx);
+}
+
+void hudDraw(Hud& hud, const HudStats& stats, const GpuProfiler& profiler, const GBuffer& gb, SSR& ssr)
+{
+    PROFILE_ZONE("hudDraw");
+
+    hud.cpuFrameMs[hud.next] = stats.cpuFrameMs;
+    hud.gpuFrameMs[hud.next] = gpuProfilerLatest(profiler, "frame");
+    hud.next = (hud.next + 1) % Hud::HISTORY;
+
+    if(!hud.visible || !hud.context)
+    {
+        return;
+    }
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    detail::hudInput(hud, viewport[2], viewport[3]);
+    detail::hudLayout(hud, stats, profiler, gb, ssr);
+    detail::hudRender(hud, viewport[2], viewport[3]);
+}
+
+void hudDelete(Hud& hud)
+{
+    nk_font_atlas_clear(&hud.context->atlas);
+    nk_buffer_free(&hud.context->commands);
+    nk_free(&hud.context->ctx);
+    delete hud.context;
+    hud.context = nullptr;
+
+    glDeleteTextures(1, &hud.font);
+    glDeleteBuffers(1, &hud.vbo);
+    glDeleteBuffers(1, &hud.ebo);
+    glDeleteVertexArrays(1, &hud.vao);
+    shaderDelete(hud.shader);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "mygl/base.h"
+#include "mygl/shader.h"
+#include "mygl/gpuprofiler.h"
+#include "ssr.h"
+
+#include <vector>
+
+/* nuklear state, only known to hud.cpp */
+struct HudContext;
+
+struct HudStats
+{
+    /* cpu times of the last frame in milliseconds */
+    float cpuFrameMs = 0.0f;
+    float cpuUpdateMs = 0.0f;
+    float cpuDrawMs = 0.0f;
+    float cpuHudMs = 0.0f;
+
+    /* geometry submitted in the last frame */
+    unsigned int drawCalls = 0;
+    unsigned int triangles = 0;
+};
+
+struct Hud
+{
+    static constexpr unsigned int HISTORY = 120;
+
+    bool visible = false;
+
+    /* input is polled from this window, may be null */
+    GLFWwindow* window = nullptr;
+    HudContext* context = nullptr;
+
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    GLuint ebo = 0;
+    GLuint font = 0;
+    ShaderProgram shader;
+
+    /* cpu and gpu frame times of the last HISTORY frames for the graph */
+    std::vector<float> cpuFrameMs = std::vector<float>(HISTORY, 0.0f);
+    std::vector<float> gpuFrameMs = std::vector<float>(HISTORY, 0.0f);
+    unsigned int next = 0;
+};
+
+/**
+ * @brief Creates the performance overlay: font atlas, buffers and shader for drawing nuklear's command lists.
+ *
+ * @param window Window the mouse input is read from, may be null for an overlay without input.
+ *
+ * @return Initialized, hidden hud.
+ */
+Hud hudCreate(GLFWwindow* window);
+
+/**
+ * @brief Checks if the mouse is over the overlay, so scene controls can ignore it.
+ *
+ * @param hud Hud.
+ *
+ * @return True if the overlay is visible and hovered.
+ */
+bool hudHovered(const Hud& hud);
+
+/**
+ * @brief Builds and draws the overlay into the viewport of the bound draw framebuffer. Shows frame times, the passes
+ * of the gpu profiler, the cpu timings and geometry counts of the last frame, render target memory and sliders for the
+ * trace parameters of the ssr pass.
+ *
+ * @param hud Hud.
+ * @param stats Cpu timings and geometry counts of the last frame.
+ * @param profiler Gpu profiler of the scene.
+ * @param gb GBuffer, its size is used for the memory estimate.
+ * @param ssr SSR pass, its trace parameters are changed by the sliders.
+ */
+void hudDraw(Hud& hud, const HudStats& stats, const GpuProfiler& profiler, const GBuffer& gb, SSR& ssr);
+
+/**
+ * @brief Cleanup and delete all OpenGL objects and the nuklear state of the hud.
+ *
+ * @param hud Hud to delete.
+ */
+void hudDelete(Hud& hud);
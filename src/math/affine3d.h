@@ -0,0 +1,224 @@
+#pragma once
+
+#include "matrix4d.h"
+
+/* affine transformation as the upper 3 rows of a 4x4 matrix, the last row is implicitly (0 0 0 1). Stored row major
+ * so it uploads as 3 vec4 rows, a quarter smaller than a Matrix4D */
+struct alignas(16) Affine3D
+{
+    float n[3][4];
+
+    constexpr Affine3D() noexcept
+        : n{}
+    {
+
+    }
+
+    constexpr Affine3D(float n00, float n01, float n02, float n03,
+                       float n10, float n11, float n12, float n13,
+                       float n20, float n21, float n22, float n23) noexcept
+        : n{{n00, n01, n02, n03},
+            {n10, n11, n12, n13},
+            {n20, n21, n22, n23}}
+    {
+
+    }
+
+    constexpr Affine3D(const Matrix3D& M, const Vector3D& t = Vector3D()) noexcept
+        : n{{M(0,0), M(0,1), M(0,2), t.x},
+            {M(1,0), M(1,1), M(1,2), t.y},
+            {M(2,0), M(2,1), M(2,2), t.z}}
+    {
+
+    }
+
+    /* drops the projective row, M has to be affine */
+    explicit constexpr Affine3D(const Matrix4D& M) noexcept
+        : n{{M(0,0), M(0,1), M(0,2), M(0,3)},
+            {M(1,0), M(1,1), M(1,2), M(1,3)},
+            {M(2,0), M(2,1), M(2,2), M(2,3)}}
+    {
+
+    }
+
+    explicit constexpr operator Matrix4D() const noexcept
+    {
+        return Matrix4D(n[0][0], n[0][1], n[0][2], n[0][3],
+                        n[1][0], n[1][1], n[1][2], n[1][3],
+                        n[2][0], n[2][1], n[2][2], n[2][3],
+                        0,       0,       0,       1);
+    }
+
+    static constexpr Affine3D identity() noexcept
+    {
+        return Affine3D(1, 0, 0, 0,
+                        0, 1, 0, 0,
+                        0, 0, 1, 0);
+    }
+
+    static constexpr Affine3D scale(float sx, float sy, float sz) noexcept
+    {
+        return Affine3D(Matrix3D::scale(sx, sy, sz));
+    }
+
+    static Affine3D rotationX(float r) noexcept
+    {
+        return Affine3D(Matrix3D::rotationX(r));
+    }
+
+    static Affine3D rotationY(float r) noexcept
+    {
+        return Affine3D(Matrix3D::rotationY(r));
+    }
+
+    static Affine3D rotationZ(float r) noexcept
+    {
+        return Affine3D(Matrix3D::rotationZ(r));
+    }
+
+    static Affine3D rotation(float r, const Vector3D& a) noexcept
+    {
+        return Affine3D(Matrix3D::rotation(r, a));
+    }
+
+    static constexpr Affine3D translation(const Vector3D& v) noexcept
+    {
+        return Affine3D(Matrix3D::identity(), v);
+    }
+
+    constexpr float& operator ()(int i, int j) noexcept
+    {
+        assert(i < 3 && j < 4);
+        return n[i][j];
+    }
+
+    constexpr const float& operator ()(int i, int j) const noexcept
+    {
+        assert(i < 3 && j < 4);
+        return n[i][j];
+    }
+
+    /* column j, column 3 is the translation */
+    constexpr Vector3D column(int j) const noexcept
+    {
+        assert(j < 4);
+        return Vector3D(n[0][j], n[1][j], n[2][j]);
+    }
+
+    constexpr const float* ptr() const noexcept
+    {
+        return &(n[0][0]);
+    }
+
+    constexpr bool operator ==(const Affine3D& A) const noexcept = default;
+};
+
+/* 36 multiplies and 27 adds instead of the 64 and 48 of a Matrix4D product */
+constexpr Affine3D operator *(const Affine3D& A, const Affine3D& B) noexcept
+{
+#ifdef MATRIX4D_SSE2
+    if(!std::is_constant_evaluated())
+    {
+        /* row i of the product is A(i,0) B0 + A(i,1) B1 + A(i,2) B2 + (0 0 0 A(i,3)) */
+        __m128 b[3] = {_mm_load_ps(B.n[0]), _mm_load_ps(B.n[1]), _mm_load_ps(B.n[2])};
+        const __m128 translation = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+
+        Affine3D R;
+        for(int i = 0; i < 3; i++)
+        {
+            __m128 a = _mm_load_ps(A.n[i]);
+            __m128 r = _mm_and_ps(a, translation);
+            r = _mm_add_ps(r, _mm_mul_ps(detail::matrix4dSplat<0>(a), b[0]));
+            r = _mm_add_ps(r, _mm_mul_ps(detail::matrix4dSplat<1>(a), b[1]));
+            r = _mm_add_ps(r, _mm_mul_ps(detail::matrix4dSplat<2>(a), b[2]));
+            _mm_store_ps(R.n[i], r);
+        }
+        return R;
+    }
+#endif
+    Affine3D R;
+    for(int i = 0; i < 3; i++)
+    {
+        for(int j = 0; j < 4; j++)
+        {
+            R.n[i][j] = A.n[i][0] * B.n[0][j] + A.n[i][1] * B.n[1][j] + A.n[i][2] * B.n[2][j];
+        }
+        R.n[i][3] += A.n[i][3];
+    }
+    return R;
+}
+
+constexpr Vector3D transformPoint(const Affine3D& A, const Vector3D& p) noexcept
+{
+    return Vector3D(A(0,0) * p.x + A(0,1) * p.y + A(0,2) * p.z + A(0,3),
+                    A(1,0) * p.x + A(1,1) * p.y + A(1,2) * p.z + A(1,3),
+                    A(2,0) * p.x + A(2,1) * p.y + A(2,2) * p.z + A(2,3));
+}
+
+constexpr Vector3D transformDirection(const Affine3D& A, const Vector3D& d) noexcept
+{
+    return Vector3D(A(0,0) * d.x + A(0,1) * d.y + A(0,2) * d.z,
+                    A(1,0) * d.x + A(1,1) * d.y + A(1,2) * d.z,
+                    A(2,0) * d.x + A(2,1) * d.y + A(2,2) * d.z);
+}
+
+/* inverse of the 3x3 part from its cofactors, the translation is moved back through it */
+constexpr Affine3D inverse(const Affine3D& A) noexcept
+{
+    Vector3D a = A.column(0);
+    Vector3D b = A.column(1);
+    Vector3D c = A.column(2);
+
+    Vector3D r0 = cross(b, c);
+    Vector3D r1 = cross(c, a);
+    Vector3D r2 = cross(a, b);
+
+    float invDet = 1.0f / dot(r2, c);
+    r0 *= invDet;
+    r1 *= invDet;
+    r2 *= invDet;
+
+    Vector3D t = A.column(3);
+    return Affine3D(r0.x, r0.y, r0.z, -dot(r0, t),
+                    r1.x, r1.y, r1.z, -dot(r1, t),
+                    r2.x, r2.y, r2.z, -dot(r2, t));
+}
+
+/* inverse transpose of the 3x3 part, transforms normals */
+constexpr Matrix3D normalMatrix(const Affine3D& A) noexcept
+{
+    Vector3D a = A.column(0);
+    Vector3D b = A.column(1);
+    Vector3D c = A.column(2);
+
+    Vector3D r0 = cross(b, c);
+    Vector3D r1 = cross(c, a);
+    Vector3D r2 = cross(a, b);
+
+    float invDet = 1.0f / dot(r2, c);
+
+    return (Matrix3D(r0.x * invDet, r1.x * invDet, r2.x * invDet,
+                     r0.y * invDet, r1.y * invDet, r2.y * invDet,
+                     r0.z * invDet, r1.z * invDet, r2.z * invDet));
+}
+
+inline const std::string toString(const Affine3D& A)
+{
+    return toString(Matrix4D(A));
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Affine3D& A)
+{
+    os << toString(A);
+    return os;
+}
+
+/* compile time checks */
+static_assert(sizeof(Affine3D) == 3 * sizeof(Vector4D));
+static_assert(Matrix4D(Affine3D::translation(Vector3D(1, 2, 3)) * Affine3D::scale(2, 2, 2)) ==
+              Matrix4D::translation(Vector3D(1, 2, 3)) * Matrix4D::scale(2, 2, 2));
+static_assert(Affine3D(Matrix4D(Affine3D::translation(Vector3D(1, 2, 3)))) == Affine3D::translation(Vector3D(1, 2, 3)));
+static_assert(inverse(Affine3D::translation(Vector3D(1, 2, 3)) * Affine3D::scale(2, 4, 8)) ==
+              Affine3D::scale(0.5f, 0.25f, 0.125f) * Affine3D::translation(Vector3D(-1, -2, -3)));
+static_assert(transformPoint(Affine3D::translation(Vector3D(1, 2, 3)), Vector3D(1, 1, 1)) == Vector3D(2, 3, 4));
+static_assert(transformDirection(Affine3D::translation(Vector3D(1, 2, 3)), Vector3D(1, 1, 1)) == Vector3D(1, 1, 1));
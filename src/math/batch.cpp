@@ -0,0 +1,248 @@
+#include "batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BATCH_SSE2
+#endif
+
+namespace detail
+{
+
+/* runs fn(begin, end) on ranges of at least BATCH_PARALLEL_COUNT elements, one per hardware thread. Range borders are
+ * multiples of 4 so only the last range has a scalar tail */
+template<typename Fn>
+void batchParallel(std::size_t count, Fn fn)
+{
+    std::size_t threads = std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                                                count / BATCH_PARALLEL_COUNT);
+    if(threads <= 1)
+    {
+        fn(std::size_t(0), count);
+        return;
+    }
+
+    std::size_t chunk = (count / threads + 3) & ~std::size_t(3);
+    std::vector<std::thread> workers;
+    for(std::size_t begin = chunk; begin < count; begin += chunk)
+    {
+        workers.emplace_back(fn, begin, std::min(count, begin + chunk));
+    }
+    fn(std::size_t(0), chunk);
+
+    for(auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+/* upper 3x4 of M, element (i, j) is row i and column j */
+struct BatchAffine
+{
+    float m[3][4];
+};
+
+inline BatchAffine batchAffine(const Matrix4D& M, bool absolute = false)
+{
+    BatchAffine A;
+    for(int i = 0; i < 3; i++)
+    {
+        for(int j = 0; j < 4; j++)
+        {
+            A.m[i][j] = absolute ? std::fabs(M(i, j)) : M(i, j);
+        }
+    }
+    return A;
+}
+
+#ifdef BATCH_SSE2
+/* the matrix with every element splat into a register */
+struct BatchAffineSSE
+{
+    __m128 m[3][4];
+};
+
+inline BatchAffineSSE batchAffineSSE(const BatchAffine& A)
+{
+    BatchAffineSSE S;
+    for(int i = 0; i < 3; i++)
+    {
+        for(int j = 0; j < 4; j++)
+        {
+            S.m[i][j] = _mm_set1_ps(A.m[i][j]);
+        }
+    }
+    return S;
+}
+
+/* row i of A times (x, y, z, w) for four vectors, w is 1 with translate and 0 without */
+template<bool translate>
+inline __m128 batchRow(const BatchAffineSSE& A, int i, __m128 x, __m128 y, __m128 z)
+{
+    __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(A.m[i][0], x), _mm_mul_ps(A.m[i][1], y)), _mm_mul_ps(A.m[i][2], z));
+    return translate ? _mm_add_ps(r, A.m[i][3]) : r;
+}
+#endif
+
+template<bool translate>
+inline float batchRow(const BatchAffine& A, int i, float x, float y, float z)
+{
+    float r = A.m[i][0] * x + A.m[i][1] * y + A.m[i][2] * z;
+    return translate ? r + A.m[i][3] : r;
+}
+
+template<bool translate>
+void batchTransformRange(const BatchAffine& A, const Vector3DArrays& in, const Vector3DArrays& out,
+                         std::size_t begin, std::size_t end)
+{
+    std::size_t i = begin;
+#ifdef BATCH_SSE2
+    BatchAffineSSE S = batchAffineSSE(A);
+    for(; i + 4 <= end; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(in.x + i);
+        __m128 y = _mm_loadu_ps(in.y + i);
+        __m128 z = _mm_loadu_ps(in.z + i);
+        _mm_storeu_ps(out.x + i, batchRow<translate>(S, 0, x, y, z));
+        _mm_storeu_ps(out.y + i, batchRow<translate>(S, 1, x, y, z));
+        _mm_storeu_ps(out.z + i, batchRow<translate>(S, 2, x, y, z));
+    }
+#endif
+    for(; i < end; i++)
+    {
+        float x = in.x[i];
+        float y = in.y[i];
+        float z = in.z[i];
+        out.x[i] = batchRow<translate>(A, 0, x, y, z);
+        out.y[i] = batchRow<translate>(A, 1, x, y, z);
+        out.z[i] = batchRow<translate>(A, 2, x, y, z);
+    }
+}
+
+/* transforms the center and takes the extents along the absolute matrix (Arvo) */
+void batchTransformAABBRange(const BatchAffine& A, const BatchAffine& absA, const AABBArrays& in, const AABBArrays& out,
+                             std::size_t begin, std::size_t end)
+{
+    std::size_t i = begin;
+#ifdef BATCH_SSE2
+    BatchAffineSSE S = batchAffineSSE(A);
+    BatchAffineSSE absS = batchAffineSSE(absA);
+    const __m128 half = _mm_set1_ps(0.5f);
+    for(; i + 4 <= end; i += 4)
+    {
+        __m128 minX = _mm_loadu_ps(in.min.x + i);
+        __m128 minY = _mm_loadu_ps(in.min.y + i);
+        __m128 minZ = _mm_loadu_ps(in.min.z + i);
+        __m128 maxX = _mm_loadu_ps(in.max.x + i);
+        __m128 maxY = _mm_loadu_ps(in.max.y + i);
+        __m128 maxZ = _mm_loadu_ps(in.max.z + i);
+
+        __m128 cX = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+        __m128 cY = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+        __m128 cZ = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+        __m128 eX = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+        __m128 eY = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+        __m128 eZ = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+        float* outMin[3] = {out.min.x + i, out.min.y + i, out.min.z + i};
+        float* outMax[3] = {out.max.x + i, out.max.y + i, out.max.z + i};
+        for(int row = 0; row < 3; row++)
+        {
+            __m128 c = batchRow<true>(S, row, cX, cY, cZ);
+            __m128 e = batchRow<false>(absS, row, eX, eY, eZ);
+            _mm_storeu_ps(outMin[row], _mm_sub_ps(c, e));
+            _mm_storeu_ps(outMax[row], _mm_add_ps(c, e));
+        }
+    }
+#endif
+    for(; i < end; i++)
+    {
+        float cX = (in.min.x[i] + in.max.x[i]) * 0.5f;
+        float cY = (in.min.y[i] + in.max.y[i]) * 0.5f;
+        float cZ = (in.min.z[i] + in.max.z[i]) * 0.5f;
+        float eX = (in.max.x[i] - in.min.x[i]) * 0.5f;
+        float eY = (in.max.y[i] - in.min.y[i]) * 0.5f;
+        float eZ = (in.max.z[i] - in.min.z[i]) * 0.5f;
+
+        float* outMin[3] = {out.min.x + i, out.min.y + i, out.min.z + i};
+        float* outMax[3] = {out.max.x + i, out.max.y + i, out.max.z + i};
+        for(int row = 0; row < 3; row++)
+        {
+            float c = batchRow<true>(A, row, cX, cY, cZ);
+            float e = batchRow<false>(absA, row, eX, eY, eZ);
+            *outMin[row] = c - e;
+            *outMax[row] = c + e;
+        }
+    }
+}
+
+void batchMultiplyRange(const Matrix4D* A, const Matrix4D* B, Matrix4D* out, std::size_t begin, std::size_t end)
+{
+    for(std::size_t i = begin; i < end; i++)
+    {
+#ifdef BATCH_SSE2
+        /* all of A is loaded before out is written, out may alias A. Column j of B is only read before column j of out
+         * is written, out may alias B */
+        __m128 a[4];
+        for(int j = 0; j < 4; j++)
+        {
+            a[j] = _mm_load_ps(A[i].n[j]);
+        }
+
+        for(int j = 0; j < 4; j++)
+        {
+            __m128 b = _mm_load_ps(B[i].n[j]);
+            __m128 r = _mm_mul_ps(a[0], _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 0, 0, 0)));
+            r = _mm_add_ps(r, _mm_mul_ps(a[1], _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 1, 1))));
+            r = _mm_add_ps(r, _mm_mul_ps(a[2], _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 2, 2))));
+            r = _mm_add_ps(r, _mm_mul_ps(a[3], _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 3, 3))));
+            _mm_store_ps(out[i].n[j], r);
+        }
+#else
+        out[i] = A[i] * B[i];
+#endif
+    }
+}
+
+}
+
+void batchTransformPoints(const Matrix4D& M, const Vector3DArrays& in, const Vector3DArrays& out, std::size_t count)
+{
+    detail::BatchAffine A = detail::batchAffine(M);
+    detail::batchParallel(count, [&](std::size_t begin, std::size_t end)
+    {
+        detail::batchTransformRange<true>(A, in, out, begin, end);
+    });
+}
+
+void batchTransformDirections(const Matrix4D& M, const Vector3DArrays& in, const Vector3DArrays& out, std::size_t count)
+{
+    detail::BatchAffine A = detail::batchAffine(M);
+    detail::batchParallel(count, [&](std::size_t begin, std::size_t end)
+    {
+        detail::batchTransformRange<false>(A, in, out, begin, end);
+    });
+}
+
+void batchMultiply(const Matrix4D* A, const Matrix4D* B, Matrix4D* out, std::size_t count)
+{
+    /* a product is 16 times the work of a point */
+    detail::batchParallel(count * 16, [&](std::size_t begin, std::size_t end)
+    {
+        detail::batchMultiplyRange(A, B, out, begin / 16, end / 16);
+    });
+}
+
+void batchTransformAABBs(const Matrix4D& M, const AABBArrays& in, const AABBArrays& out, std::size_t count)
+{
+    detail::BatchAffine A = detail::batchAffine(M);
+    detail::BatchAffine absA = detail::batchAffine(M, true);
+    detail::batchParallel(count, [&](std::size_t begin, std::size_t end)
+    {
+        detail::batchTransformAABBRange(A, absA, in, out, begin, end);
+    });
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "matrix4d.h"
+
+#include <cstddef>
+
+/* structure of arrays, element i is (x[i], y[i], z[i]). Inputs are only read, outputs may be the inputs */
+struct Vector3DArrays
+{
+    float* x = nullptr;
+    float* y = nullptr;
+    float* z = nullptr;
+};
+
+/* axis aligned boxes as structure of arrays */
+struct AABBArrays
+{
+    Vector3DArrays min;
+    Vector3DArrays max;
+};
+
+/* batches of at least this many elements per thread are split across the hardware threads */
+constexpr std::size_t BATCH_PARALLEL_COUNT = std::size_t(1) << 16;
+
+/**
+ * @brief Transforms points (w = 1) by an affine matrix, four at a time with SSE2.
+ *
+ * @param M Affine transformation, the projective row is ignored.
+ * @param in Points to transform.
+ * @param out Transformed points, may be in.
+ * @param count Number of points.
+ */
+void batchTransformPoints(const Matrix4D& M, const Vector3DArrays& in, const Vector3DArrays& out, std::size_t count);
+
+/**
+ * @brief Transforms directions (w = 0) by a matrix, the translation is ignored. Normals need the normalMatrix of a
+ * non-rigid transformation instead.
+ *
+ * @param M Transformation.
+ * @param in Directions to transform.
+ * @param out Transformed directions, may be in.
+ * @param count Number of directions.
+ */
+void batchTransformDirections(const Matrix4D& M, const Vector3DArrays& in, const Vector3DArrays& out, std::size_t count);
+
+/**
+ * @brief Composes two arrays of matrices element wise, out[i] = A[i] * B[i].
+ *
+ * @param A Left matrices, e.g. parent transformations.
+ * @param B Right matrices, e.g. local transformations.
+ * @param out Products, may be A or B.
+ * @param count Number of matrices.
+ */
+void batchMultiply(const Matrix4D* A, const Matrix4D* B, Matrix4D* out, std::size_t count);
+
+/**
+ * @brief Transforms axis aligned boxes by an affine matrix, out is the tight box around each transformed box.
+ *
+ * @param M Affine transformation, the projective row is ignored.
+ * @param in Boxes to transform.
+ * @param out Transformed boxes, may be in.
+ * @param count Number of boxes.
+ */
+void batchTransformAABBs(const Matrix4D& M, const AABBArrays& in, const AABBArrays& out, std::size_t count);
@@ -3,42 +3,410 @@
 #include "matrix3d.h"
 #include "vector4d.h"
 
+#include <type_traits>
 
-struct Matrix4D
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MATRIX4D_SSE2
+#endif
+
+
+/* columns are 16 byte aligned so they can be loaded into SSE registers directly, the layout is unchanged */
+struct alignas(16) Matrix4D
 {
     float n[4][4];
 
-    Matrix4D();
-    Matrix4D(float n00, float n01, float n02, float n03,
-             float n10, float n11, float n12, float n13,
-             float n20, float n21, float n22, float n23,
-             float n30, float n31, float n32, float n33);
-
-    Matrix4D(const Vector4D& a, const Vector4D& b, const Vector4D& c, const Vector4D& d);
-    Matrix4D(const Matrix3D& M);
-
-    static Matrix4D identity();
-    static Matrix4D scale(float sx, float sy, float sz);
-    static Matrix4D rotationX(float r);
-    static Matrix4D rotationY(float r);
-    static Matrix4D rotationZ(float r);
-    static Matrix4D rotation(float r, const Vector3D& a);
-    static Matrix4D translation(const Vector3D& v);
-    static Matrix4D perspective(float fov, float aspect, float nearPlane, float farPlane);
-    static Matrix4D ortho(float left, float bottom, float right, float top, float nearPlane, float farPlane);
-
-    float& operator ()(int i, int j);
-    const float& operator ()(int i, int j) const;
-    Vector4D& operator [](int j);
-    const Vector4D& operator [](int j) const;
-    const float* ptr() const;
+    constexpr Matrix4D() noexcept
+        : n{}
+    {
+
+    }
+
+    constexpr Matrix4D(float n00, float n01, float n02, float n03,
+                       float n10, float n11, float n12, float n13,
+                       float n20, float n21, float n22, float n23,
+                       float n30, float n31, float n32, float n33) noexcept
+        : n{{n00, n10, n20, n30},
+            {n01, n11, n21, n31},
+            {n02, n12, n22, n32},
+            {n03, n13, n23, n33}}
+    {
+
+    }
+
+    constexpr Matrix4D(const Vector4D& a, const Vector4D& b, const Vector4D& c, const Vector4D& d) noexcept
+        : n{{a.x, a.y, a.z, a.w},
+            {b.x, b.y, b.z, b.w},
+            {c.x, c.y, c.z, c.w},
+            {d.x, d.y, d.z, d.w}}
+    {
+
+    }
+
+    constexpr Matrix4D(const Matrix3D& M) noexcept
+        : n{{M(0,0), M(1,0), M(2,0), 0},
+            {M(0,1), M(1,1), M(2,1), 0},
+            {M(0,2), M(1,2), M(2,2), 0},
+            {0,      0,      0,      1}}
+    {
+
+    }
+
+    static constexpr Matrix4D identity() noexcept
+    {
+        return Matrix4D(1, 0, 0, 0,
+                        0, 1, 0, 0,
+                        0, 0, 1, 0,
+                        0, 0, 0, 1);
+    }
+
+    static constexpr Matrix4D scale(float sx, float sy, float sz) noexcept
+    {
+        return Matrix4D(Matrix3D::scale(sx, sy, sz));
+    }
+
+    static Matrix4D rotationX(float r) noexcept
+    {
+        return Matrix4D(Matrix3D::rotationX(r));
+    }
+
+    static Matrix4D rotationY(float r) noexcept
+    {
+        return Matrix4D(Matrix3D::rotationY(r));
+    }
+
+    static Matrix4D rotationZ(float r) noexcept
+    {
+        return Matrix4D(Matrix3D::rotationZ(r));
+    }
+
+    static Matrix4D rotation(float r, const Vector3D& a) noexcept
+    {
+        return Matrix4D(Matrix3D::rotation(r, a));
+    }
+
+    static constexpr Matrix4D translation(const Vector3D& v) noexcept
+    {
+        return Matrix4D(1, 0, 0, v.x,
+                        0, 1, 0, v.y,
+                        0, 0, 1, v.z,
+                        0, 0, 0,  1  );
+    }
+
+    static Matrix4D perspective(float fov, float aspect, float nearPlane, float farPlane) noexcept
+    {
+        float f = 1.0f / std::tan(0.5 * fov);
+        float c1 = -(farPlane + nearPlane) / (farPlane - nearPlane);
+        float c2 = -(2.0 * farPlane * nearPlane) / (farPlane - nearPlane);
+
+        return Matrix4D(f/aspect,   0,  0,  0,
+                        0,          f,  0,  0,
+                        0,          0,  c1, c2,
+                        0,          0,  -1,  0);
+    }
+
+    static constexpr Matrix4D ortho(float left, float bottom, float right, float top, float near, float far) noexcept
+    {
+        return Matrix4D(
+                    2.0f / (right - left),  0.0f,                   0.0f,                   -(right+left)/(right-left),
+                    0.0f,                   2.0f / (top - bottom),  0.0f,                   -(top+bottom)/(top-bottom),
+                    0.0f,                   0.0f,                   -2.0f / (far - near),   -(far+near)/(far-near),
+                    0.0f,                   0.0f,                   0.0f,                   1.0f
+                    );
+    }
+
+    constexpr float& operator ()(int i, int j) noexcept
+    {
+        assert(i < 4 && j < 4);
+        return n[j][i];
+    }
+
+    constexpr const float& operator ()(int i, int j) const noexcept
+    {
+        assert(i < 4 && j < 4);
+        return n[j][i];
+    }
+
+    Vector4D& operator [](int j) noexcept
+    {
+        assert(j < 4);
+        return *reinterpret_cast<Vector4D *>(n[j]);
+    }
+
+    const Vector4D& operator [](int j) const noexcept
+    {
+        assert(j < 4);
+        return *reinterpret_cast<const Vector4D *>(n[j]);
+    }
+
+    constexpr const float* ptr() const noexcept
+    {
+        return &(n[0][0]);
+    }
+
+    constexpr bool operator ==(const Matrix4D& M) const noexcept = default;
 
     friend std::ostream& operator<<(std::ostream& os, const Matrix4D& M);
 };
 
-Matrix4D operator *(const Matrix4D& A, const Matrix4D& B);
-Vector4D operator *(const Matrix4D& M, const Vector4D& v);
+constexpr Matrix3D::Matrix3D(const Matrix4D& M) noexcept
+    : n{{M(0,0), M(1,0), M(2,0)},
+        {M(0,1), M(1,1), M(2,1)},
+        {M(0,2), M(1,2), M(2,2)}}
+{
+
+}
+
+namespace detail
+{
+
+/* scalar reference implementations, used for constant evaluation and without SSE2 */
+constexpr Matrix4D matrix4dMulScalar(const Matrix4D& A, const Matrix4D& B) noexcept
+{
+    return Matrix4D(A(0,0) * B(0,0) + A(0,1) * B(1,0) + A(0,2) * B(2,0) + A(0,3) * B(3,0),
+                    A(0,0) * B(0,1) + A(0,1) * B(1,1) + A(0,2) * B(2,1) + A(0,3) * B(3,1),
+                    A(0,0) * B(0,2) + A(0,1) * B(1,2) + A(0,2) * B(2,2) + A(0,3) * B(3,2),
+                    A(0,0) * B(0,3) + A(0,1) * B(1,3) + A(0,2) * B(2,3) + A(0,3) * B(3,3),
+
+                    A(1,0) * B(0,0) + A(1,1) * B(1,0) + A(1,2) * B(2,0) + A(1,3) * B(3,0),
+                    A(1,0) * B(0,1) + A(1,1) * B(1,1) + A(1,2) * B(2,1) + A(1,3) * B(3,1),
+                    A(1,0) * B(0,2) + A(1,1) * B(1,2) + A(1,2) * B(2,2) + A(1,3) * B(3,2),
+                    A(1,0) * B(0,3) + A(1,1) * B(1,3) + A(1,2) * B(2,3) + A(1,3) * B(3,3),
+
+                    A(2,0) * B(0,0) + A(2,1) * B(1,0) + A(2,2) * B(2,0) + A(2,3) * B(3,0),
+                    A(2,0) * B(0,1) + A(2,1) * B(1,1) + A(2,2) * B(2,1) + A(2,3) * B(3,1),
+                    A(2,0) * B(0,2) + A(2,1) * B(1,2) + A(2,2) * B(2,2) + A(2,3) * B(3,2),
+                    A(2,0) * B(0,3) + A(2,1) * B(1,3) + A(2,2) * B(2,3) + A(2,3) * B(3,3),
+
+                    A(3,0) * B(0,0) + A(3,1) * B(1,0) + A(3,2) * B(2,0) + A(3,3) * B(3,0),
+                    A(3,0) * B(0,1) + A(3,1) * B(1,1) + A(3,2) * B(2,1) + A(3,3) * B(3,1),
+                    A(3,0) * B(0,2) + A(3,1) * B(1,2) + A(3,2) * B(2,2) + A(3,3) * B(3,2),
+                    A(3,0) * B(0,3) + A(3,1) * B(1,3) + A(3,2) * B(2,3) + A(3,3) * B(3,3));
+}
+
+constexpr Vector4D matrix4dTransformScalar(const Matrix4D& M, const Vector4D& v) noexcept
+{
+    return Vector4D(M(0,0) * v.x + M(0,1) * v.y + M(0,2) * v.z + M(0,3) * v.w,
+                    M(1,0) * v.x + M(1,1) * v.y + M(1,2) * v.z + M(1,3) * v.w,
+                    M(2,0) * v.x + M(2,1) * v.y + M(2,2) * v.z + M(2,3) * v.w,
+                    M(3,0) * v.x + M(3,1) * v.y + M(3,2) * v.z + M(3,3) * v.w);
+}
+
+constexpr Matrix4D matrix4dInverseScalar(const Matrix4D& M) noexcept
+{
+    Vector3D a(M(0,0), M(1,0), M(2,0));
+    Vector3D b(M(0,1), M(1,1), M(2,1));
+    Vector3D c(M(0,2), M(1,2), M(2,2));
+    Vector3D d(M(0,3), M(1,3), M(2,3));
+
+    const float& x = M(3,0);
+    const float& y = M(3,1);
+    const float& z = M(3,2);
+    const float& w = M(3,3);
+
+    Vector3D s = cross(a, b);
+    Vector3D t = cross(c, d);
+    Vector3D u = a * y - b * x;
+    Vector3D v = c * w - d * z;
+
+    float invDet = 1.0f / (dot(s, v) + dot(t, u));
+    s *= invDet;
+    t *= invDet;
+    u *= invDet;
+    v *= invDet;
 
-Matrix4D inverse(const Matrix4D& M);
+    Vector3D r0 = cross(b, v) + t * y;
+    Vector3D r1 = cross(v, a) - t * x;
+    Vector3D r2 = cross(d, u) + s * w;
+    Vector3D r3 = cross(u, c) - s * z;
+
+    return (Matrix4D(r0.x, r0.y, r0.z, -dot(b, t),
+                     r1.x, r1.y, r1.z,  dot(a, t),
+                     r2.x, r2.y, r2.z, -dot(d, s),
+                     r3.x, r3.y, r3.z,  dot(c, s)));
+}
+
+}
+
+#ifdef MATRIX4D_SSE2
+namespace detail
+{
+
+/* component i of every lane */
+template<int i>
+inline __m128 matrix4dSplat(__m128 v) noexcept
+{
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(i, i, i, i));
+}
+
+template<int x, int y, int z, int w>
+inline __m128 matrix4dSwizzle(__m128 v) noexcept
+{
+    return _mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(v), _MM_SHUFFLE(w, z, y, x)));
+}
+
+/* M * v for a matrix given as four column registers */
+inline __m128 matrix4dTransform(const __m128 col[4], __m128 v) noexcept
+{
+    __m128 r = _mm_mul_ps(col[0], matrix4dSplat<0>(v));
+    r = _mm_add_ps(r, _mm_mul_ps(col[1], matrix4dSplat<1>(v)));
+    r = _mm_add_ps(r, _mm_mul_ps(col[2], matrix4dSplat<2>(v)));
+    r = _mm_add_ps(r, _mm_mul_ps(col[3], matrix4dSplat<3>(v)));
+    return r;
+}
+
+/* 2x2 blocks stored as (m00, m01, m10, m11): A * B, adj(A) * B and A * adj(B) */
+inline __m128 matrix4dMul2(__m128 a, __m128 b) noexcept
+{
+    return _mm_add_ps(_mm_mul_ps(a, matrix4dSwizzle<0, 3, 0, 3>(b)),
+                      _mm_mul_ps(matrix4dSwizzle<1, 0, 3, 2>(a), matrix4dSwizzle<2, 1, 2, 1>(b)));
+}
+
+inline __m128 matrix4dAdjMul2(__m128 a, __m128 b) noexcept
+{
+    return _mm_sub_ps(_mm_mul_ps(matrix4dSwizzle<3, 3, 0, 0>(a), b),
+                      _mm_mul_ps(matrix4dSwizzle<1, 1, 2, 2>(a), matrix4dSwizzle<2, 3, 0, 1>(b)));
+}
+
+inline __m128 matrix4dMulAdj2(__m128 a, __m128 b) noexcept
+{
+    return _mm_sub_ps(_mm_mul_ps(a, matrix4dSwizzle<3, 0, 3, 0>(b)),
+                      _mm_mul_ps(matrix4dSwizzle<1, 0, 3, 2>(a), matrix4dSwizzle<2, 1, 2, 1>(b)));
+}
+
+}
+#endif
+
+/* the SSE paths are taken at runtime, constant evaluation uses the scalar code */
+constexpr Matrix4D operator *(const Matrix4D& A, const Matrix4D& B) noexcept
+{
+#ifdef MATRIX4D_SSE2
+    if(!std::is_constant_evaluated())
+    {
+        /* column j of the product is A times column j of B */
+        __m128 a[4] = {_mm_load_ps(A.n[0]), _mm_load_ps(A.n[1]), _mm_load_ps(A.n[2]), _mm_load_ps(A.n[3])};
+
+        Matrix4D R;
+        for(int j = 0; j < 4; j++)
+        {
+            _mm_store_ps(R.n[j], detail::matrix4dTransform(a, _mm_load_ps(B.n[j])));
+        }
+        return R;
+    }
+#endif
+    return detail::matrix4dMulScalar(A, B);
+}
+
+constexpr Vector4D operator *(const Matrix4D& M, const Vector4D& v) noexcept
+{
+#ifdef MATRIX4D_SSE2
+    if(!std::is_constant_evaluated())
+    {
+        __m128 m[4] = {_mm_load_ps(M.n[0]), _mm_load_ps(M.n[1]), _mm_load_ps(M.n[2]), _mm_load_ps(M.n[3])};
+
+        Vector4D r;
+        _mm_storeu_ps(&r.x, detail::matrix4dTransform(m, _mm_loadu_ps(&v.x)));
+        return r;
+    }
+#endif
+    return detail::matrix4dTransformScalar(M, v);
+}
+
+constexpr Matrix4D inverse(const Matrix4D& M) noexcept
+{
+#ifdef MATRIX4D_SSE2
+    if(!std::is_constant_evaluated())
+    {
+        /* block wise inverse over the 2x2 sub matrices. It works on the transpose since the columns are loaded as
+         * rows, which is fine as the inverse of the transpose is the transpose of the inverse */
+        __m128 c0 = _mm_load_ps(M.n[0]);
+        __m128 c1 = _mm_load_ps(M.n[1]);
+        __m128 c2 = _mm_load_ps(M.n[2]);
+        __m128 c3 = _mm_load_ps(M.n[3]);
+
+        __m128 A = _mm_movelh_ps(c0, c1);
+        __m128 B = _mm_movehl_ps(c1, c0);
+        __m128 C = _mm_movelh_ps(c2, c3);
+        __m128 D = _mm_movehl_ps(c3, c2);
+
+        /* determinants of the blocks as (|A| |B| |C| |D|) */
+        __m128 detSub = _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(3, 1, 3, 1))),
+                                   _mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(2, 0, 2, 0))));
+        __m128 detA = detail::matrix4dSplat<0>(detSub);
+        __m128 detB = detail::matrix4dSplat<1>(detSub);
+        __m128 detC = detail::matrix4dSplat<2>(detSub);
+        __m128 detD = detail::matrix4dSplat<3>(detSub);
+
+        __m128 D_C = detail::matrix4dAdjMul2(D, C);
+        __m128 A_B = detail::matrix4dAdjMul2(A, B);
+        __m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), detail::matrix4dMul2(B, D_C));
+        __m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), detail::matrix4dMul2(C, A_B));
+        __m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), detail::matrix4dMulAdj2(D, A_B));
+        __m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), detail::matrix4dMulAdj2(A, D_C));
+
+        /* |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C) */
+        __m128 tr = _mm_mul_ps(A_B, detail::matrix4dSwizzle<0, 2, 1, 3>(D_C));
+        tr = _mm_add_ps(tr, _mm_movehl_ps(tr, tr));
+        tr = _mm_add_ss(tr, detail::matrix4dSplat<1>(tr));
+        __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), detail::matrix4dSplat<0>(tr));
+
+        __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+        X = _mm_mul_ps(X, rDetM);
+        Y = _mm_mul_ps(Y, rDetM);
+        Z = _mm_mul_ps(Z, rDetM);
+        W = _mm_mul_ps(W, rDetM);
+
+        /* adjugate of the blocks and back to columns */
+        Matrix4D R;
+        _mm_store_ps(R.n[0], _mm_shuffle_ps(X, Y, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_store_ps(R.n[1], _mm_shuffle_ps(X, Y, _MM_SHUFFLE(0, 2, 0, 2)));
+        _mm_store_ps(R.n[2], _mm_shuffle_ps(Z, W, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_store_ps(R.n[3], _mm_shuffle_ps(Z, W, _MM_SHUFFLE(0, 2, 0, 2)));
+        return R;
+    }
+#endif
+    return detail::matrix4dInverseScalar(M);
+}
+
+/* inverse transpose of the upper 3x3 part, transforms normals for an affine M. Much cheaper than inverse because the
+ * projective row is ignored */
+constexpr Matrix3D normalMatrix(const Matrix4D& M) noexcept
+{
+    Vector3D a(M(0,0), M(1,0), M(2,0));
+    Vector3D b(M(0,1), M(1,1), M(2,1));
+    Vector3D c(M(0,2), M(1,2), M(2,2));
+
+    /* rows of the 3x3 inverse are the cofactors, transposed they become the columns */
+    Vector3D r0 = cross(b, c);
+    Vector3D r1 = cross(c, a);
+    Vector3D r2 = cross(a, b);
+
+    float invDet = 1.0f / dot(r2, c);
+
+    return (Matrix3D(r0.x * invDet, r1.x * invDet, r2.x * invDet,
+                     r0.y * invDet, r1.y * invDet, r2.y * invDet,
+                     r0.z * invDet, r1.z * invDet, r2.z * invDet));
+}
+
+inline const std::string toString(const Matrix4D& M)
+{
+    return std::to_string(M(0, 0)) + " " + std::to_string(M(0, 1)) + " " + std::to_string(M(0, 2)) + " " + std::to_string(M(0,3)) + "\n"
+        + std::to_string(M(1, 0)) + " " + std::to_string(M(1, 1)) + " " + std::to_string(M(1, 2)) + " " + std::to_string(M(1,3)) + "\n"
+        + std::to_string(M(2, 0)) + " " + std::to_string(M(2, 1)) + " " + std::to_string(M(2, 2)) + " " + std::to_string(M(2,3)) + "\n"
+        + std::to_string(M(3, 0)) + " " + std::to_string(M(3, 1)) + " " + std::to_string(M(3, 2)) + " " + std::to_string(M(3,3));
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Matrix4D& M)
+{
+    os << toString(M);
+    return os;
+}
 
-const std::string toString(const Matrix4D& M);
+/* compile time checks */
+static_assert(Matrix4D::translation(Vector3D(1, 2, 3)) * Vector4D(1, 1, 1, 1) == Vector4D(2, 3, 4, 1));
+static_assert(Matrix4D::translation(Vector3D(1, 2, 3)) * Vector4D(1, 1, 1, 0) == Vector4D(1, 1, 1, 0));
+static_assert(Matrix4D::translation(Vector3D(1, 2, 3)) * Matrix4D::translation(Vector3D(-1, -2, -3)) == Matrix4D::identity());
+static_assert(inverse(Matrix4D::translation(Vector3D(1, 2, 3)) * Matrix4D::scale(2, 4, 8)) ==
+              Matrix4D::scale(0.5f, 0.25f, 0.125f) * Matrix4D::translation(Vector3D(-1, -2, -3)));
+static_assert(normalMatrix(Matrix4D::scale(2, 4, 8)) == Matrix3D::scale(0.5f, 0.25f, 0.125f));
+static_assert(Matrix3D(Matrix4D(Matrix3D::scale(1, 2, 3))) == Matrix3D::scale(1, 2, 3));
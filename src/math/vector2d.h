@@ -1,41 +1,137 @@
 #pragma once
 
+#include <cassert>
+#include <cmath>
+#include <ostream>
 #include <string>
 
 struct Vector2D
 {
     float x, y;
 
-    Vector2D(float x = 0, float y = 0);
+    constexpr Vector2D(float x = 0, float y = 0) noexcept
+        : x(x), y(y)
+    {
 
-    Vector2D& operator *=(float s);
-    Vector2D& operator /=(float s);
+    }
 
-    Vector2D& operator +=(const Vector2D& v);
-    Vector2D& operator -=(const Vector2D& v);
+    constexpr Vector2D& operator *=(float s) noexcept
+    {
+        x *= s;
+        y *= s;
+        return *this;
+    }
 
-     Vector2D operator -() const;
+    constexpr Vector2D& operator /=(float s) noexcept
+    {
+        assert(s != 0.0f);
+        return *this *= (1.0 / s);
+    }
 
-    float& operator [](unsigned int i);
-    const float& operator [](unsigned int i) const;
+    constexpr Vector2D& operator +=(const Vector2D& v) noexcept
+    {
+        x += v.x;
+        y += v.y;
+        return *this;
+    }
+
+    constexpr Vector2D& operator -=(const Vector2D& v) noexcept
+    {
+        x -= v.x;
+        y -= v.y;
+        return *this;
+    }
+
+    constexpr Vector2D operator -() const noexcept
+    {
+        return Vector2D(-x, -y);
+    }
+
+    float& operator [](unsigned int i) noexcept
+    {
+        assert(i < 2);
+        return (&x)[i];
+    }
+
+    const float& operator [](unsigned int i) const noexcept
+    {
+        assert(i < 2);
+        return (&x)[i];
+    }
+
+    constexpr bool operator ==(const Vector2D& v) const noexcept = default;
 
     friend std::ostream& operator<<(std::ostream& os, const Vector2D& v);
 };
 
-Vector2D operator *(const Vector2D& v, float s);
-Vector2D operator /(const Vector2D& v, float s);
-Vector2D operator *(float s, const Vector2D& v);
-Vector2D operator /(float s, const Vector2D& v);
+constexpr Vector2D operator *(const Vector2D& v, float s) noexcept
+{
+    return Vector2D(v.x * s, v.y * s);
+}
+
+constexpr Vector2D operator /(const Vector2D& v, float s) noexcept
+{
+    return Vector2D(v.x / s, v.y / s);
+}
+
+constexpr Vector2D operator *(float s, const Vector2D& v) noexcept
+{
+    return Vector2D(v.x * s, v.y * s);
+}
+
+constexpr Vector2D operator /(float s, const Vector2D& v) noexcept
+{
+    return Vector2D(v.x / s, v.y / s);
+}
+
+constexpr Vector2D operator +(const Vector2D& a, const Vector2D& b) noexcept
+{
+    return Vector2D(a.x + b.x, a.y + b.y);
+}
 
-Vector2D operator +(const Vector2D& a, const Vector2D& b);
-Vector2D operator -(const Vector2D& a, const Vector2D& b);
+constexpr Vector2D operator -(const Vector2D& a, const Vector2D& b) noexcept
+{
+    return Vector2D(a.x - b.x, a.y - b.y);
+}
 
-float length(const Vector2D& v);
-Vector2D normalize(const Vector2D& v);
+inline float length(const Vector2D& v) noexcept
+{
+    return std::sqrt(v.x*v.x + v.y*v.y);
+}
 
-float dot(const Vector2D& a, const Vector2D& b);
+inline Vector2D normalize(const Vector2D& v) noexcept
+{
+    assert(length(v) != 0.0f);
+    return v / length(v);
+}
 
-Vector2D project(const Vector2D& a, const Vector2D& b);
-Vector2D reject(const Vector2D& a, const Vector2D& b);
+constexpr float dot(const Vector2D& a, const Vector2D& b) noexcept
+{
+    return a.x * b.x + a.y * b.y;
+}
+
+constexpr Vector2D project(const Vector2D& a, const Vector2D& b) noexcept
+{
+    return (b * (dot(a, b) / dot(b, b)));
+}
+
+constexpr Vector2D reject(const Vector2D& a, const Vector2D& b) noexcept
+{
+    return (a - b * (dot(a, b) / dot(b, b)));
+}
+
+inline const std::string toString(const Vector2D& v)
+{
+    return "x: " +  std::to_string(v.x) + ", y: " + std::to_string(v.y);
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Vector2D& v)
+{
+    os << toString(v);
+    return os;
+}
 
-const std::string toString(const Vector2D& v);
+/* compile time checks */
+static_assert(Vector2D(1, 2) * 2.0f - Vector2D(1, 1) == Vector2D(1, 3));
+static_assert(dot(Vector2D(1, 2), Vector2D(3, 4)) == 11.0f);
+static_assert(project(Vector2D(2, 3), Vector2D(1, 0)) == Vector2D(2, 0));
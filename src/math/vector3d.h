@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cassert>
+#include <cmath>
+#include <ostream>
 #include <string>
 
 struct Vector4D;
@@ -9,38 +12,148 @@ struct Vector3D
     float x, y, z;
 
 
-    Vector3D(float x = 0, float y = 0, float z = 0);
-    Vector3D(const Vector4D& v);
+    constexpr Vector3D(float x = 0, float y = 0, float z = 0) noexcept
+        : x(x), y(y), z(z)
+    {
 
-    Vector3D& operator *=(float s);
-    Vector3D& operator /=(float s);
+    }
 
-    Vector3D& operator +=(const Vector3D& v);
-    Vector3D& operator -=(const Vector3D& v);
+    /* defined in vector4d.h */
+    constexpr Vector3D(const Vector4D& v) noexcept;
 
-    Vector3D operator -() const;
+    constexpr Vector3D& operator *=(float s) noexcept
+    {
+        x *= s;
+        y *= s;
+        z *= s;
 
-    float& operator [](unsigned int i);
-    const float& operator [](unsigned int i) const;
+        return *this;
+    }
+
+    constexpr Vector3D& operator /=(float s) noexcept
+    {
+        assert(s != 0.0f);
+        return *this *= (1.0 / s);
+    }
+
+    constexpr Vector3D& operator +=(const Vector3D& v) noexcept
+    {
+        x += v.x;
+        y += v.y;
+        z += v.z;
+
+        return *this;
+    }
+
+    constexpr Vector3D& operator -=(const Vector3D& v) noexcept
+    {
+        x -= v.x;
+        y -= v.y;
+        z -= v.z;
+
+        return *this;
+    }
+
+    constexpr Vector3D operator -() const noexcept
+    {
+        return Vector3D(-x, -y, -z);
+    }
+
+    float& operator [](unsigned int i) noexcept
+    {
+        assert(i < 3);
+        return (&x)[i];
+    }
+
+    const float& operator [](unsigned int i) const noexcept
+    {
+        assert(i < 3);
+        return (&x)[i];
+    }
+
+    constexpr bool operator ==(const Vector3D& v) const noexcept = default;
 
     friend std::ostream& operator<<(std::ostream& os, const Vector3D& v);
 };
 
-Vector3D operator *(const Vector3D& v, float s);
-Vector3D operator /(const Vector3D& v, float s);
-Vector3D operator *(float s, const Vector3D& v);
-Vector3D operator /(float s, const Vector3D& v);
+constexpr Vector3D operator *(const Vector3D& v, float s) noexcept
+{
+    return Vector3D(v.x * s, v.y * s, v.z * s);
+}
+
+constexpr Vector3D operator /(const Vector3D& v, float s) noexcept
+{
+    return Vector3D(v.x / s, v.y / s, v.z / s);
+}
+
+constexpr Vector3D operator *(float s, const Vector3D& v) noexcept
+{
+    return Vector3D(v.x * s, v.y * s, v.z * s);
+}
+
+constexpr Vector3D operator /(float s, const Vector3D& v) noexcept
+{
+    return Vector3D(v.x / s, v.y / s, v.z / s);
+}
+
+constexpr Vector3D operator +(const Vector3D& a, const Vector3D& b) noexcept
+{
+    return Vector3D(a.x + b.x, a.y + b.y, a.z + b.z);
+}
 
-Vector3D operator +(const Vector3D& a, const Vector3D& b);
-Vector3D operator -(const Vector3D& a, const Vector3D& b);
+constexpr Vector3D operator -(const Vector3D& a, const Vector3D& b) noexcept
+{
+    return Vector3D(a.x - b.x, a.y - b.y, a.z - b.z);
+}
 
-float length(const Vector3D& v);
-Vector3D normalize(const Vector3D& v);
+inline float length(const Vector3D& v) noexcept
+{
+    return std::sqrt(v.x*v.x + v.y*v.y + v.z*v.z);
+}
 
-float dot(const Vector3D& a, const Vector3D& b);
-Vector3D cross(const Vector3D& a, const Vector3D& b);
+inline Vector3D normalize(const Vector3D& v) noexcept
+{
+    assert(length(v) != 0.0f);
+    return v / length(v);
+}
 
-Vector3D project(const Vector3D& a, const Vector3D& b);
-Vector3D reject(const Vector3D& a, const Vector3D& b);
+constexpr float dot(const Vector3D& a, const Vector3D& b) noexcept
+{
+    return a.x*b.x + a.y*b.y + a.z*b.z;
+}
 
-const std::string toString(const Vector3D& v);
+constexpr Vector3D cross(const Vector3D& a, const Vector3D& b) noexcept
+{
+    return Vector3D(
+                a.y * b.z - a.z * b.y,
+                a.z * b.x - a.x * b.z,
+                a.x * b.y - a.y * b.x
+                );
+}
+
+constexpr Vector3D project(const Vector3D& a, const Vector3D& b) noexcept
+{
+    return (b * (dot(a, b) / dot(b, b)));
+}
+
+constexpr Vector3D reject(const Vector3D& a, const Vector3D& b) noexcept
+{
+    return (a - b * (dot(a, b) / dot(b, b)));
+}
+
+inline const std::string toString(const Vector3D& v)
+{
+    return "x: " +  std::to_string(v.x) + ", y: " + std::to_string(v.y) + ", z: " + std::to_string(v.z);
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Vector3D& v)
+{
+    os << toString(v);
+    return os;
+}
+
+/* compile time checks */
+static_assert(cross(Vector3D(1, 0, 0), Vector3D(0, 1, 0)) == Vector3D(0, 0, 1));
+static_assert(dot(Vector3D(1, 2, 3), Vector3D(4, 5, 6)) == 32.0f);
+static_assert(reject(Vector3D(2, 3, 4), Vector3D(0, 0, 2)) == Vector3D(2, 3, 0));
+static_assert((Vector3D(1, 2, 3) += Vector3D(1, 1, 1)) / 2.0f == Vector3D(1, 1.5f, 2));
@@ -7,29 +7,123 @@ struct Vector4D
     float x, y, z, w;
 
 
-    Vector4D(const Vector3D& v, float w = 1.0f);
-    Vector4D(float x = 0, float y = 0, float z = 0, float w = 0);
+    constexpr Vector4D(const Vector3D& v, float w = 1.0f) noexcept
+        : x(v.x), y(v.y), z(v.z), w(w)
+    {
 
-    Vector4D& operator *=(float s);
-    Vector4D& operator /=(float s);
+    }
 
-    Vector4D& operator +=(const Vector4D& v);
-    Vector4D& operator -=(const Vector4D& v);
+    constexpr Vector4D(float x = 0, float y = 0, float z = 0, float w = 0) noexcept
+        : x(x), y(y), z(z), w(w)
+    {
 
-    Vector4D operator -() const;
+    }
 
-    float& operator [](unsigned int i);
-    const float& operator [](unsigned int i) const;
+    constexpr Vector4D& operator *=(float s) noexcept
+    {
+        x *= s;
+        y *= s;
+        z *= s;
+        w *= s;
+        return *this;
+    }
+
+    constexpr Vector4D& operator /=(float s) noexcept
+    {
+        assert(s != 0.0f);
+        return *this *= (1.0 / s);
+    }
+
+    constexpr Vector4D& operator +=(const Vector4D& v) noexcept
+    {
+        x += v.x;
+        y += v.y;
+        z += v.z;
+        w += v.w;
+
+        return *this;
+    }
+
+    constexpr Vector4D& operator -=(const Vector4D& v) noexcept
+    {
+        x -= v.x;
+        y -= v.y;
+        z -= v.z;
+        w -= v.w;
+
+        return *this;
+    }
+
+    constexpr Vector4D operator -() const noexcept
+    {
+        return Vector4D(-x, -y, -z, -w);
+    }
+
+    float& operator [](unsigned int i) noexcept
+    {
+        assert(i < 4);
+        return ((&x)[i]);
+    }
+
+    const float& operator [](unsigned int i) const noexcept
+    {
+        assert(i < 4);
+        return ((&x)[i]);
+    }
+
+    constexpr bool operator ==(const Vector4D& v) const noexcept = default;
 
     friend std::ostream& operator<<(std::ostream& os, const Vector4D& v);
 };
 
-Vector4D operator *(const Vector4D& v, float s);
-Vector4D operator /(const Vector4D& v, float s);
-Vector4D operator *(float s, const Vector4D& v);
-Vector4D operator /(float s, const Vector4D& v);
+constexpr Vector3D::Vector3D(const Vector4D& v) noexcept
+    : x(v.x), y(v.y), z(v.z)
+{
+
+}
+
+constexpr Vector4D operator *(const Vector4D& v, float s) noexcept
+{
+    return Vector4D(v.x * s, v.y * s, v.z * s, v.w * s);
+}
+
+constexpr Vector4D operator /(const Vector4D& v, float s) noexcept
+{
+    return Vector4D(v.x / s, v.y / s, v.z / s, v.w / s);
+}
+
+constexpr Vector4D operator *(float s, const Vector4D& v) noexcept
+{
+    return Vector4D(v.x * s, v.y * s, v.z * s, v.w * s);
+}
 
-Vector4D operator +(const Vector4D& a, const Vector4D& b);
-Vector4D operator -(const Vector4D& a, const Vector4D& b);
+constexpr Vector4D operator /(float s, const Vector4D& v) noexcept
+{
+    return Vector4D(v.x / s, v.y / s, v.z / s, v.w / s);
+}
+
+constexpr Vector4D operator +(const Vector4D& a, const Vector4D& b) noexcept
+{
+    return Vector4D(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+}
+
+constexpr Vector4D operator -(const Vector4D& a, const Vector4D& b) noexcept
+{
+    return Vector4D(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
+}
+
+inline const std::string toString(const Vector4D& v)
+{
+    return "x: " +  std::to_string(v.x) + ", y: " + std::to_string(v.y) + ", z: " + std::to_string(v.z) + ", w: " + std::to_string(v.w);
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Vector4D& v)
+{
+    os << toString(v);
+    return os;
+}
 
-const std::string toString(const Vector4D& v);
+/* compile time checks */
+static_assert(Vector3D(Vector4D(1, 2, 3, 4)) == Vector3D(1, 2, 3));
+static_assert(Vector4D(Vector3D(1, 2, 3)).w == 1.0f);
+static_assert(-Vector4D(1, 2, 3, 4) + Vector4D(1, 2, 3, 4) * 2.0f == Vector4D(1, 2, 3, 4));
@@ -31,7 +31,7 @@ GLenum glCheckError_(const char *file, int line)
     return errorCode;
 }
 
-void screenshotToPNG(const std::string &filepath)
+void screenshotToPNG(const std::string &filepath, GLuint fbo)
 {
     GLint viewport[4];
     glGetIntegerv(GL_VIEWPORT, viewport);
@@ -42,9 +42,15 @@ void screenshotToPNG(const std::string &filepath)
 
     std::vector<GLubyte> data(4 * nPixels);
 
-    glReadBuffer(GL_FRONT);
+    GLint readFbo = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFbo);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glReadBuffer(fbo == 0 ? GL_FRONT : GL_COLOR_ATTACHMENT0);
     glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
 
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFbo);
+
     stbi_flip_vertically_on_write(true);
     stbi_write_png(filepath.c_str(), width, height, 4, data.data(), width * 4);
 }
@@ -54,7 +60,7 @@ void glfw_error_callback(int error, const char* description)
     std::cerr << "GLFW Error: " <<  description << std::endl;
 }
 
-GLFWwindow* windowCreate(const std::string& title, unsigned int width = 1280, unsigned int height = 720)
+GLFWwindow* windowCreate(const std::string& title, unsigned int width, unsigned int height, bool visible, bool vsync)
 {
     /*-------------- init glfw ----------------*/
     if(!glfwInit())
@@ -72,6 +78,7 @@ GLFWwindow* windowCreate(const std::string& title, unsigned int width = 1280, un
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
 
 #ifdef __APPLE__
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
@@ -88,7 +95,7 @@ GLFWwindow* windowCreate(const std::string& title, unsigned int width = 1280, un
 
     /* make context the current one */
     glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);
+    glfwSwapInterval(vsync ? 1 : 0);
 
     /*-------------- init glad ----------------*/
     /* load opengl extensions */
@@ -16,6 +16,7 @@
 #include "math/vector4d.h"
 #include "math/matrix3d.h"
 #include "math/matrix4d.h"
+#include "math/affine3d.h"
 
 
 /**
@@ -24,10 +25,12 @@
  * @param title Window title
  * @param width Window width
  * @param height Window height
+ * @param visible Whether the window is shown, hidden windows still provide the OpenGL context
+ * @param vsync Whether buffer swaps wait for the vertical refresh
  *
  * @return Initialized GLFW window.
  */
-GLFWwindow* windowCreate(const std::string &title, unsigned int width, unsigned int height);
+GLFWwindow* windowCreate(const std::string &title, unsigned int width = 1280, unsigned int height = 720, bool visible = true, bool vsync = true);
 /**
  * @brief Delete GLFW window and OpenGL contexst. Has to be called for each window after it is not used anymore.
  *
@@ -39,8 +42,9 @@ void windowDelete(GLFWwindow* window);
  * @brief Save current viewport as PNG image.
  *
  * @param filepath Path to output image.
+ * @param fbo Framebuffer to read, 0 reads the front buffer of the window, otherwise its first color attachment.
  */
-void screenshotToPNG(const std::string &filepath);
+void screenshotToPNG(const std::string &filepath, GLuint fbo = 0);
 
 /**
  * @brief Debugging function that checks for OpenGL errors and prints them if there are any.
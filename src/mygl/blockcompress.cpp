@@ -0,0 +1,187 @@
+#include "blockcompress.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BLOCKCOMPRESS_SSE2
+#endif
+
+namespace detail
+{
+
+/* copies a 4x4 block, pixels outside the image repeat the last row/column */
+void blockFetch(const std::uint8_t* rgba, unsigned int width, unsigned int height, unsigned int bx, unsigned int by,
+                std::uint8_t block[64])
+{
+    for(unsigned int y = 0; y < 4; y++)
+    {
+        unsigned int sy = std::min(by * 4 + y, height - 1);
+        for(unsigned int x = 0; x < 4; x++)
+        {
+            unsigned int sx = std::min(bx * 4 + x, width - 1);
+            std::memcpy(block + (y * 4 + x) * 4, rgba + (std::size_t(sy) * width + sx) * 4, 4);
+        }
+    }
+}
+
+/* per channel minimum and maximum of the 16 pixels */
+void blockBounds(const std::uint8_t block[64], std::uint8_t lo[4], std::uint8_t hi[4])
+{
+#ifdef BLOCKCOMPRESS_SSE2
+    /* one row of four pixels per register, reduce across the rows and then across the pixels */
+    __m128i r0 = _mm_loadu_si128((const __m128i*) (block + 0));
+    __m128i r1 = _mm_loadu_si128((const __m128i*) (block + 16));
+    __m128i r2 = _mm_loadu_si128((const __m128i*) (block + 32));
+    __m128i r3 = _mm_loadu_si128((const __m128i*) (block + 48));
+
+    __m128i mn = _mm_min_epu8(_mm_min_epu8(r0, r1), _mm_min_epu8(r2, r3));
+    __m128i mx = _mm_max_epu8(_mm_max_epu8(r0, r1), _mm_max_epu8(r2, r3));
+    mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(1, 0, 3, 2)));
+    mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(1, 0, 3, 2)));
+    mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(2, 3, 0, 1)));
+    mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    int mnBits = _mm_cvtsi128_si32(mn);
+    int mxBits = _mm_cvtsi128_si32(mx);
+    std::memcpy(lo, &mnBits, 4);
+    std::memcpy(hi, &mxBits, 4);
+#else
+    for(int c = 0; c < 4; c++)
+    {
+        lo[c] = 255;
+        hi[c] = 0;
+    }
+    for(int i = 0; i < 16; i++)
+    {
+        for(int c = 0; c < 4; c++)
+        {
+            lo[c] = std::min(lo[c], block[i * 4 + c]);
+            hi[c] = std::max(hi[c], block[i * 4 + c]);
+        }
+    }
+#endif
+}
+
+std::uint16_t blockPack565(const int c[3])
+{
+    return std::uint16_t(((c[0] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[2] >> 3));
+}
+
+void blockUnpack565(std::uint16_t v, int c[3])
+{
+    int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    c[0] = (r << 3) | (r >> 2);
+    c[1] = (g << 2) | (g >> 4);
+    c[2] = (b << 3) | (b >> 2);
+}
+
+/* 8 byte color block, always four color mode */
+void blockEncodeColor(const std::uint8_t block[64], const std::uint8_t lo[4], const std::uint8_t hi[4], std::uint8_t* out)
+{
+    /* shrink the bounding box a bit, the extremes are rarely the best endpoints */
+    int minColor[3], maxColor[3];
+    for(int c = 0; c < 3; c++)
+    {
+        int inset = (hi[c] - lo[c]) >> 4;
+        minColor[c] = lo[c] + inset;
+        maxColor[c] = hi[c] - inset;
+    }
+
+    /* each channel of max is >= min, so is the packed value */
+    std::uint16_t c0 = blockPack565(maxColor);
+    std::uint16_t c1 = blockPack565(minColor);
+
+    std::uint32_t indices = 0;
+    if(c0 != c1)
+    {
+        int e0[3], e1[3];
+        blockUnpack565(c0, e0);
+        blockUnpack565(c1, e1);
+
+        int axis[3] = {e0[0] - e1[0], e0[1] - e1[1], e0[2] - e1[2]};
+        int length = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+
+        /* palette position along the axis -> index, c1 is index 1 and c0 index 0 */
+        static const std::uint32_t remap[4] = {1, 3, 2, 0};
+        for(int i = 0; i < 16; i++)
+        {
+            const std::uint8_t* p = block + i * 4;
+            int t = (p[0] - e1[0]) * axis[0] + (p[1] - e1[1]) * axis[1] + (p[2] - e1[2]) * axis[2];
+            int q = std::clamp((6 * t + length) / (2 * length), 0, 3);
+            indices |= remap[q] << (2 * i);
+        }
+    }
+
+    out[0] = c0 & 0xFF;
+    out[1] = c0 >> 8;
+    out[2] = c1 & 0xFF;
+    out[3] = c1 >> 8;
+    out[4] = indices & 0xFF;
+    out[5] = (indices >> 8) & 0xFF;
+    out[6] = (indices >> 16) & 0xFF;
+    out[7] = indices >> 24;
+}
+
+/* 8 byte alpha block, always eight value mode */
+void blockEncodeAlpha(const std::uint8_t block[64], std::uint8_t lo, std::uint8_t hi, std::uint8_t* out)
+{
+    std::uint64_t indices = 0;
+    if(hi != lo)
+    {
+        int range = hi - lo;
+        for(int i = 0; i < 16; i++)
+        {
+            int q = ((block[i * 4 + 3] - lo) * 14 + range) / (2 * range);
+            /* 7 is alpha0 (hi) and 0 is alpha1 (lo), in between they are stored from hi to lo */
+            std::uint64_t index = q == 7 ? 0 : q == 0 ? 1 : 8 - q;
+            indices |= index << (3 * i);
+        }
+    }
+
+    out[0] = hi;
+    out[1] = lo;
+    for(int i = 0; i < 6; i++)
+    {
+        out[2 + i] = (indices >> (8 * i)) & 0xFF;
+    }
+}
+
+}
+
+std::size_t blockCompressedSize(unsigned int width, unsigned int height, std::size_t blockSize)
+{
+    return std::size_t((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+}
+
+void blockCompressBC1(const std::uint8_t* rgba, unsigned int width, unsigned int height, std::uint8_t* out)
+{
+    std::uint8_t block[64], lo[4], hi[4];
+    for(unsigned int by = 0; by < (height + 3) / 4; by++)
+    {
+        for(unsigned int bx = 0; bx < (width + 3) / 4; bx++)
+        {
+            detail::blockFetch(rgba, width, height, bx, by, block);
+            detail::blockBounds(block, lo, hi);
+            detail::blockEncodeColor(block, lo, hi, out);
+            out += BC1_BLOCK_SIZE;
+        }
+    }
+}
+
+void blockCompressBC3(const std::uint8_t* rgba, unsigned int width, unsigned int height, std::uint8_t* out)
+{
+    std::uint8_t block[64], lo[4], hi[4];
+    for(unsigned int by = 0; by < (height + 3) / 4; by++)
+    {
+        for(unsigned int bx = 0; bx < (width + 3) / 4; bx++)
+        {
+            detail::blockFetch(rgba, width, height, bx, by, block);
+            detail::blockBounds(block, lo, hi);
+            detail::blockEncodeAlpha(block, lo[3], hi[3], out);
+            detail::blockEncodeColor(block, lo, hi, out + 8);
+            out += BC3_BLOCK_SIZE;
+        }
+    }
+}
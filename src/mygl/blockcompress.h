@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/* bytes of one compressed 4x4 block */
+constexpr std::size_t BC1_BLOCK_SIZE = 8;
+constexpr std::size_t BC3_BLOCK_SIZE = 16;
+
+/**
+ * @brief Size of an image compressed with 4x4 blocks, partial blocks at the right and top edge count as full blocks.
+ *
+ * @param width Image width.
+ * @param height Image height.
+ * @param blockSize BC1_BLOCK_SIZE or BC3_BLOCK_SIZE.
+ *
+ * @return Size of the compressed image in bytes.
+ */
+std::size_t blockCompressedSize(unsigned int width, unsigned int height, std::size_t blockSize);
+
+/**
+ * @brief Compresses an RGBA8 image to BC1 (DXT1), alpha is dropped. Endpoints are the inset bounding box of the block
+ * colors, which is fast enough to run at load time but is not as exact as an offline encoder.
+ *
+ * @param rgba Tightly packed RGBA8 pixels.
+ * @param width Image width.
+ * @param height Image height.
+ * @param out Output of blockCompressedSize(width, height, BC1_BLOCK_SIZE) bytes.
+ */
+void blockCompressBC1(const std::uint8_t* rgba, unsigned int width, unsigned int height, std::uint8_t* out);
+
+/**
+ * @brief Compresses an RGBA8 image to BC3 (DXT5), a BC1 color block and an interpolated alpha block per 4x4 pixels.
+ *
+ * @param rgba Tightly packed RGBA8 pixels.
+ * @param width Image width.
+ * @param height Image height.
+ * @param out Output of blockCompressedSize(width, height, BC3_BLOCK_SIZE) bytes.
+ */
+void blockCompressBC3(const std::uint8_t* rgba, unsigned int width, unsigned int height, std::uint8_t* out);
@@ -0,0 +1,373 @@
+#include "capture.h"
+
+#include "cpuprofiler.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <stb_image/stb_image_write.h>
+
+struct CaptureJob
+{
+    /* position in the output, dropped frames do not get one */
+    unsigned int index = 0;
+    std::vector<unsigned char> pixels;
+};
+
+struct CaptureWorker
+{
+    /* copy of the settings, the Capture itself may move */
+    Capture::eFormat format = Capture::Y4M;
+    std::string path;
+    unsigned int width = 0;
+    unsigned int height = 0;
+
+    std::mutex mutex;
+    std::condition_variable jobReady;
+    std::condition_variable jobDone;
+
+    std::deque<CaptureJob> jobs;
+    std::size_t bytes = 0;
+    bool stop = false;
+
+    /* y4m frames are converted in parallel but written in order */
+    std::FILE* file = nullptr;
+    unsigned int nextWrite = 0;
+
+    unsigned int queued = 0;
+    unsigned int written = 0;
+    std::uint64_t lastWriteNs = 0;
+
+    std::vector<std::thread> threads;
+};
+
+namespace detail
+{
+
+/* full range BT.601 like jpeg (C420jpeg), chroma averaged over 2x2 pixels. Rows are flipped, OpenGL starts at the bottom */
+void captureToYuv(unsigned int w, unsigned int h, const std::vector<unsigned char>& rgba, std::vector<unsigned char>& yuv)
+{
+    unsigned int cw = (w + 1) / 2, ch = (h + 1) / 2;
+    yuv.resize(w * h + 2 * cw * ch);
+
+    unsigned char* yPlane = yuv.data();
+    unsigned char* uPlane = yPlane + w * h;
+    unsigned char* vPlane = uPlane + cw * ch;
+
+    auto pixel = [&](unsigned int x, unsigned int y) { return &rgba[(std::size_t(h - 1 - y) * w + x) * 4]; };
+    auto clamp = [](float v) { return (unsigned char) std::clamp(v + 0.5f, 0.0f, 255.0f); };
+
+    for(unsigned int y = 0; y < h; y++)
+    {
+        for(unsigned int x = 0; x < w; x++)
+        {
+            const unsigned char* p = pixel(x, y);
+            yPlane[y * w + x] = clamp(0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2]);
+        }
+    }
+
+    for(unsigned int y = 0; y < ch; y++)
+    {
+        for(unsigned int x = 0; x < cw; x++)
+        {
+            float r = 0.0f, g = 0.0f, b = 0.0f, n = 0.0f;
+            for(unsigned int dy = 0; dy < 2 && 2 * y + dy < h; dy++)
+            {
+                for(unsigned int dx = 0; dx < 2 && 2 * x + dx < w; dx++)
+                {
+                    const unsigned char* p = pixel(2 * x + dx, 2 * y + dy);
+                    r += p[0]; g += p[1]; b += p[2]; n += 1.0f;
+                }
+            }
+            r /= n; g /= n; b /= n;
+
+            uPlane[y * cw + x] = clamp(128.0f - 0.168736f * r - 0.331264f * g + 0.5f * b);
+            vPlane[y * cw + x] = clamp(128.0f + 0.5f * r - 0.418688f * g - 0.081312f * b);
+        }
+    }
+}
+
+void captureEncode(CaptureWorker& worker)
+{
+    PROFILE_THREAD("capture");
+
+    std::vector<unsigned char> yuv;
+    while(true)
+    {
+        CaptureJob job;
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.jobReady.wait(lock, [&] { return worker.stop || !worker.jobs.empty(); });
+            if(worker.jobs.empty())
+            {
+                return;
+            }
+            job = std::move(worker.jobs.front());
+            worker.jobs.pop_front();
+        }
+
+        PROFILE_ZONE("captureEncode");
+        if(worker.format == Capture::PNG)
+        {
+            std::ostringstream name;
+            name << worker.path << "_" << std::setw(6) << std::setfill('0') << job.index << ".png";
+            if(!stbi_write_png(name.str().c_str(), worker.width, worker.height, 4, job.pixels.data(), worker.width * 4))
+            {
+                std::cerr << "[Capture] couldn't write " << name.str() << std::endl;
+            }
+        }
+        else
+        {
+            captureToYuv(worker.width, worker.height, job.pixels, yuv);
+        }
+
+        std::unique_lock<std::mutex> lock(worker.mutex);
+        if(worker.format == Capture::Y4M)
+        {
+            /* the smallest unwritten index was taken from the queue first, so its thread is never waiting here */
+            worker.jobDone.wait(lock, [&] { return worker.nextWrite == job.index; });
+            std::fputs("FRAME\n", worker.file);
+            std::fwrite(yuv.data(), 1, yuv.size(), worker.file);
+            worker.nextWrite++;
+        }
+
+        worker.bytes -= job.pixels.size();
+        worker.written++;
+        worker.lastWriteNs = cpuProfilerNow();
+        lock.unlock();
+        worker.jobDone.notify_all();
+    }
+}
+
+/* copies a finished readback out of its pixel buffer and queues it, or drops it if the encoders are too far behind */
+void captureCollect(Capture& cap, bool wait)
+{
+    std::size_t size = std::size_t(cap.width) * cap.height * 4;
+
+    while(cap.collected != cap.issued)
+    {
+        auto& readback = cap.readbacks[cap.collected % Capture::READBACK_COUNT];
+
+        GLenum status = glClientWaitSync(readback.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? 1000000000ull : 0);
+        if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        {
+            return;
+        }
+        glDeleteSync(readback.fence);
+        readback.fence = nullptr;
+        cap.collected++;
+
+        CaptureWorker& worker = *cap.worker;
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            if(worker.bytes + size > cap.memoryLimit)
+            {
+                if(cap.policy == Capture::DROP)
+                {
+                    cap.dropped++;
+                    continue;
+                }
+
+                PROFILE_ZONE("captureStall");
+                worker.jobDone.wait(lock, [&] { return worker.bytes + size <= cap.memoryLimit; });
+            }
+            worker.bytes += size;
+        }
+
+        CaptureJob job;
+        job.pixels.resize(size);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+        void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+        if(data)
+        {
+            std::memcpy(job.pixels.data(), data, size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            job.index = worker.queued++;
+            worker.jobs.push_back(std::move(job));
+        }
+        worker.jobReady.notify_one();
+    }
+}
+
+}
+
+Capture captureCreate(const std::string& path, unsigned int width, unsigned int height, unsigned int fps, Capture::ePolicy policy,
+                      std::size_t memoryLimit, unsigned int threads)
+{
+    Capture cap;
+    cap.path = path;
+    cap.format = path.size() >= 4 && path.compare(path.size() - 4, 4, ".y4m") == 0 ? Capture::Y4M : Capture::PNG;
+    cap.policy = policy;
+    cap.width = width;
+    cap.height = height;
+    cap.fps = fps;
+
+    /* at least one frame has to fit, otherwise every frame would be dropped */
+    cap.memoryLimit = std::max(memoryLimit, std::size_t(width) * height * 4);
+
+    auto worker = new CaptureWorker();
+    worker->format = cap.format;
+    worker->path = cap.format == Capture::PNG && path.size() >= 4 && path.compare(path.size() - 4, 4, ".png") == 0 ? path.substr(0, path.size() - 4) : path;
+    worker->width = width;
+    worker->height = height;
+    if(cap.format == Capture::Y4M)
+    {
+        worker->file = std::fopen(path.c_str(), "wb");
+        if(!worker->file)
+        {
+            std::cerr << "[Capture] couldn't open " << path << std::endl;
+            delete worker;
+            return cap;
+        }
+        std::fprintf(worker->file, "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C420jpeg\n", width, height, fps);
+    }
+    else
+    {
+        stbi_flip_vertically_on_write(true);
+    }
+    cap.worker = worker;
+
+    for(auto& readback : cap.readbacks)
+    {
+        glGenBuffers(1, &readback.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, std::size_t(width) * height * 4, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glCheckError();
+
+    /* leave two hardware threads for rendering and simulation */
+    if(threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency() - std::min(2u, std::thread::hardware_concurrency()));
+    }
+
+    for(unsigned int i = 0; i < threads; i++)
+    {
+        worker->threads.emplace_back(detail::captureEncode, std::ref(*worker));
+    }
+
+    cap.startNs = cpuProfilerNow();
+    std::cout << "[Capture] recording " << width << "x" << height << " to " << path << " with " << threads << " encoder threads" << std::endl;
+
+    return cap;
+}
+
+void captureFrame(Capture& cap, GLuint fbo)
+{
+    if(!cap.worker)
+    {
+        return;
+    }
+
+    PROFILE_ZONE("captureFrame");
+    cap.frames++;
+
+    /* hand finished readbacks to the encoders, then make room for this frame */
+    detail::captureCollect(cap, false);
+    if(cap.issued - cap.collected == Capture::READBACK_COUNT)
+    {
+        if(cap.policy == Capture::DROP)
+        {
+            cap.dropped++;
+            return;
+        }
+
+        PROFILE_ZONE("captureStall");
+        while(cap.issued - cap.collected == Capture::READBACK_COUNT)
+        {
+            detail::captureCollect(cap, true);
+        }
+    }
+
+    auto& readback = cap.readbacks[cap.issued % Capture::READBACK_COUNT];
+
+    GLint readFbo = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFbo);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glReadBuffer(fbo == 0 ? GL_FRONT : GL_COLOR_ATTACHMENT0);
+    glReadPixels(0, 0, cap.width, cap.height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    cap.issued++;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFbo);
+    glCheckError();
+}
+
+void captureReport(const Capture& cap)
+{
+    if(!cap.worker)
+    {
+        return;
+    }
+
+    unsigned int written = 0;
+    std::uint64_t lastWriteNs = 0;
+    {
+        std::lock_guard<std::mutex> lock(cap.worker->mutex);
+        written = cap.worker->written;
+        lastWriteNs = cap.worker->lastWriteNs;
+    }
+
+    /* sustained rate: frames that made it to the output over the time until the last one was written */
+    double seconds = lastWriteNs > cap.startNs ? (lastWriteNs - cap.startNs) * 1e-9 : 0.0;
+    std::cout << "[Capture] " << written << " of " << cap.frames << " frames written, " << cap.dropped << " dropped, "
+              << std::fixed << std::setprecision(1) << (seconds > 0.0 ? written / seconds : 0.0) << " fps sustained over "
+              << seconds << " s" << std::defaultfloat << std::endl;
+}
+
+void captureDelete(Capture& cap)
+{
+    if(!cap.worker)
+    {
+        return;
+    }
+
+    /* waiting is fine here, nothing is captured anymore */
+    while(cap.collected != cap.issued)
+    {
+        detail::captureCollect(cap, true);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(cap.worker->mutex);
+        cap.worker->stop = true;
+    }
+    cap.worker->jobReady.notify_all();
+    for(auto& thread : cap.worker->threads)
+    {
+        thread.join();
+    }
+
+    captureReport(cap);
+
+    if(cap.worker->file)
+    {
+        std::fclose(cap.worker->file);
+    }
+    delete cap.worker;
+    cap.worker = nullptr;
+
+    for(auto& readback : cap.readbacks)
+    {
+        glDeleteBuffers(1, &readback.pbo);
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "base.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/* encoder threads, their job queue and the output file, only known to capture.cpp */
+struct CaptureWorker;
+
+struct Capture
+{
+    enum eFormat
+    {
+        Y4M = 0,    /* one raw YUV 4:2:0 stream, frames are written in order */
+        PNG         /* numbered png files */
+    };
+
+    /* what happens if the GPU readbacks or the encoders fall behind */
+    enum ePolicy
+    {
+        DROP = 0,   /* skip the frame, the frame rate is never affected */
+        STALL       /* wait until there is room again, every frame is kept */
+    };
+
+    /* frames that are read back at once, they are mapped once their fence signaled */
+    static constexpr unsigned int READBACK_COUNT = 3;
+
+    struct Readback
+    {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+    };
+
+    eFormat format = Y4M;
+    ePolicy policy = DROP;
+    std::string path;
+
+    unsigned int width = 0;
+    unsigned int height = 0;
+    unsigned int fps = 60;
+
+    /* upper limit of pixel data waiting for or in encoding, the readback ring comes on top */
+    std::size_t memoryLimit = 0;
+
+    Readback readbacks[READBACK_COUNT];
+    unsigned int issued = 0;
+    unsigned int collected = 0;
+
+    /* frames passed to captureFrame and frames skipped by the DROP policy */
+    unsigned int frames = 0;
+    unsigned int dropped = 0;
+    std::uint64_t startNs = 0;
+
+    CaptureWorker* worker = nullptr;
+};
+
+/**
+ * @brief Starts capturing a frame sequence. Frames are read back through a ring of pixel buffers and encoded by a pool
+ * of threads.
+ *
+ * @param path Output path. Ending in .y4m writes a video stream, otherwise numbered files path_000000.png, ... (a .png
+ * extension of path is dropped)
+ * @param width Width of the captured area (from the lower left corner).
+ * @param height Height of the captured area.
+ * @param fps Frame rate written into the y4m header.
+ * @param policy What happens if capturing falls behind.
+ * @param memoryLimit Maximum bytes of frames queued for encoding.
+ * @param threads Number of encoder threads, 0 picks one per spare hardware thread.
+ *
+ * @return Running capture, check capture.worker for failure to open the output.
+ */
+Capture captureCreate(const std::string& path, unsigned int width, unsigned int height, unsigned int fps, Capture::ePolicy policy,
+                      std::size_t memoryLimit = std::size_t(256) << 20, unsigned int threads = 0);
+
+/**
+ * @brief Captures the current frame. Has to be called once per frame after drawing. Hands finished readbacks to the
+ * encoders and queues the readback of this frame.
+ *
+ * @param cap Capture.
+ * @param fbo Framebuffer to read, 0 reads the front buffer of the window, otherwise its first color attachment.
+ */
+void captureFrame(Capture& cap, GLuint fbo = 0);
+
+/**
+ * @brief Prints the number of written and dropped frames and the sustained capture rate so far.
+ *
+ * @param cap Capture.
+ */
+void captureReport(const Capture& cap);
+
+/**
+ * @brief Finishes all pending frames, stops the encoders and prints the report.
+ *
+ * @param cap Capture to delete.
+ */
+void captureDelete(Capture& cap);
@@ -0,0 +1,162 @@
+#include "cpuprofiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace detail
+{
+
+struct CpuProfilerThread
+{
+    static constexpr std::uint64_t EVENT_COUNT = 1 << 16;
+
+    CpuProfilerEvent events[EVENT_COUNT];
+
+    /* only written by the owning thread, the release store publishes the event written before it */
+    std::atomic<std::uint64_t> written{0};
+
+    unsigned int id = 0;
+    std::string name;
+};
+
+struct CpuProfilerState
+{
+    static constexpr unsigned int FRAME_COUNT = 1024;
+
+    /* buffers are never freed, threads may exit before the trace is dumped */
+    std::mutex mutex;
+    std::vector<std::unique_ptr<CpuProfilerThread>> threads;
+
+    /* start time of the last FRAME_COUNT frames */
+    std::atomic<std::uint64_t> frame{0};
+    std::atomic<std::uint64_t> frameStart[FRAME_COUNT] = {};
+};
+
+CpuProfilerState& cpuProfilerState()
+{
+    static CpuProfilerState state;
+    return state;
+}
+
+/* registration takes the lock once per thread, recording afterwards only touches the thread's own buffer */
+CpuProfilerThread& cpuProfilerThread()
+{
+    thread_local CpuProfilerThread* thread = nullptr;
+    if(!thread)
+    {
+        auto& state = cpuProfilerState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+
+        state.threads.push_back(std::make_unique<CpuProfilerThread>());
+        thread = state.threads.back().get();
+        thread->id = state.threads.size();
+        thread->name = "thread " + std::to_string(thread->id);
+    }
+
+    return *thread;
+}
+
+void cpuProfilerWriteEvent(std::ofstream& file, bool& first, const CpuProfilerEvent& event, unsigned int thread)
+{
+    file << (first ? "\n" : ",\n") << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread
+         << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+    first = false;
+}
+
+}
+
+void cpuProfilerRecord(const CpuProfilerEvent& event)
+{
+    auto& thread = detail::cpuProfilerThread();
+
+    std::uint64_t index = thread.written.load(std::memory_order_relaxed);
+    thread.events[index % detail::CpuProfilerThread::EVENT_COUNT] = event;
+    thread.written.store(index + 1, std::memory_order_release);
+}
+
+void cpuProfilerFrame()
+{
+    auto& state = detail::cpuProfilerState();
+
+    std::uint64_t frame = state.frame.load(std::memory_order_relaxed) + 1;
+    state.frameStart[frame % detail::CpuProfilerState::FRAME_COUNT].store(cpuProfilerNow(), std::memory_order_relaxed);
+    state.frame.store(frame, std::memory_order_release);
+}
+
+void cpuProfilerThreadName(const std::string& name)
+{
+    auto& thread = detail::cpuProfilerThread();
+    auto& state = detail::cpuProfilerState();
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    thread.name = name;
+}
+
+bool cpuProfilerDump(const std::string& path, unsigned int frames)
+{
+#ifndef VCPROJ_PROFILE
+    std::cerr << "[CpuProfiler] profiler is disabled, build with VCPROJ_PROFILE to record zones" << std::endl;
+    return false;
+#else
+    auto& state = detail::cpuProfilerState();
+
+    /* zones that started before the first exported frame are cut */
+    std::uint64_t frame = state.frame.load(std::memory_order_acquire);
+    frames = std::min<std::uint64_t>(std::min<std::uint64_t>(frames, frame), detail::CpuProfilerState::FRAME_COUNT - 1);
+    std::uint64_t since = frames == 0 ? 0 : state.frameStart[(frame - frames + 1) % detail::CpuProfilerState::FRAME_COUNT].load(std::memory_order_relaxed);
+
+    std::ofstream file(path);
+    if(!file.is_open())
+    {
+        std::cerr << "[CpuProfiler] Couldn't open trace file at " << path << std::endl;
+        return false;
+    }
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    unsigned int count = 0;
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for(auto& thread : state.threads)
+    {
+        file << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->id
+             << ",\"args\":{\"name\":\"" << thread->name << "\"}}";
+        first = false;
+
+        /* copy the ring, then drop everything the owner may have overwritten in the meantime */
+        std::uint64_t end = thread->written.load(std::memory_order_acquire);
+        std::uint64_t begin = end > detail::CpuProfilerThread::EVENT_COUNT ? end - detail::CpuProfilerThread::EVENT_COUNT : 0;
+
+        std::vector<CpuProfilerEvent> events(end - begin);
+        for(std::uint64_t i = begin; i < end; i++)
+        {
+            events[i - begin] = thread->events[i % detail::CpuProfilerThread::EVENT_COUNT];
+        }
+
+        /* the slot of index written - EVENT_COUNT may be in the middle of being overwritten */
+        std::uint64_t written = thread->written.load(std::memory_order_acquire);
+        std::uint64_t valid = written >= detail::CpuProfilerThread::EVENT_COUNT ? written - detail::CpuProfilerThread::EVENT_COUNT + 1 : 0;
+
+        for(std::uint64_t i = begin; i < end; i++)
+        {
+            const auto& event = events[i - begin];
+            if(i < valid || event.start < since)
+            {
+                continue;
+            }
+
+            detail::cpuProfilerWriteEvent(file, first, event, thread->id);
+            count++;
+        }
+    }
+    file << "\n]}\n";
+
+    std::cout << "[CpuProfiler] wrote " << count << " zones of the last " << frames << " frames to " << path << std::endl;
+    return true;
+#endif
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/* Zones are compiled in if VCPROJ_PROFILE is defined (CMake option VCPROJ_PROFILE), otherwise the macros below expand
+ * to nothing and the profiler has no cost at all */
+#ifdef VCPROJ_PROFILE
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) CpuProfilerZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FRAME() cpuProfilerFrame()
+#define PROFILE_THREAD(name) cpuProfilerThreadName(name)
+#else
+#define PROFILE_ZONE(name) do {} while(0)
+#define PROFILE_FRAME() do {} while(0)
+#define PROFILE_THREAD(name) do {} while(0)
+#endif
+
+struct CpuProfilerEvent
+{
+    /* has to be a string literal (or otherwise outlive the profiler), names are never copied */
+    const char* name = nullptr;
+    std::uint64_t start = 0;
+    std::uint64_t end = 0;
+};
+
+/**
+ * @brief Nanoseconds since the start of the program.
+ *
+ * @return Current profiler time.
+ */
+inline std::uint64_t cpuProfilerNow()
+{
+    static const auto startTime = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+/**
+ * @brief Appends a finished zone to the event buffer of the calling thread. Every thread writes into its own ring
+ * buffer, so recording never takes a lock.
+ *
+ * @param event Zone to record.
+ */
+void cpuProfilerRecord(const CpuProfilerEvent& event);
+
+/**
+ * @brief Marks the start of a new frame. Used to cut the trace to the last frames when dumping.
+ */
+void cpuProfilerFrame();
+
+/**
+ * @brief Names the calling thread in the trace.
+ *
+ * @param name Thread name.
+ */
+void cpuProfilerThreadName(const std::string& name);
+
+/**
+ * @brief Writes the zones of the last frames of all threads as Chrome trace JSON (viewable in chrome://tracing or
+ * Perfetto). Zones still in the buffers of other threads are copied without stopping them; zones overwritten while
+ * copying are skipped.
+ *
+ * @param path Output file.
+ * @param frames Number of frames to export.
+ *
+ * @return True if the file was written.
+ */
+bool cpuProfilerDump(const std::string& path, unsigned int frames);
+
+struct CpuProfilerZone
+{
+    CpuProfilerEvent event;
+
+    explicit CpuProfilerZone(const char* name)
+    {
+        event.name = name;
+        event.start = cpuProfilerNow();
+    }
+
+    ~CpuProfilerZone()
+    {
+        event.end = cpuProfilerNow();
+        cpuProfilerRecord(event);
+    }
+
+    CpuProfilerZone(const CpuProfilerZone&) = delete;
+    CpuProfilerZone& operator=(const CpuProfilerZone&) = delete;
+};
@@ -0,0 +1,88 @@
+#include "gbuffer.h"
+
+#include <cassert>
+#include <stdexcept>
+#include <iostream>
+
+namespace detail
+{
+
+GLuint gbufferAttachment(GLenum attachment, GLint internalFormat, GLenum format, GLenum type, GLint filter, unsigned int width, unsigned int height)
+{
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texture, 0);
+    glCheckError();
+
+    return texture;
+}
+
+}
+
+GBuffer gbufferCreate(unsigned int width, unsigned int height)
+{
+    assert(width != 0 && height != 0);
+
+    GBuffer gb;
+    gb.width = width;
+    gb.height = height;
+
+    /* create gBuffer, attach textures for position, normals, color + spec and depth */
+    glGenFramebuffers(1, &gb.fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, gb.fbo);
+
+    gb.position  = detail::gbufferAttachment(GL_COLOR_ATTACHMENT0, GL_RGBA16F, GL_RGBA, GL_FLOAT, GL_NEAREST, width, height);
+    gb.normal    = detail::gbufferAttachment(GL_COLOR_ATTACHMENT1, GL_RGBA16F, GL_RGBA, GL_FLOAT, GL_NEAREST, width, height);
+    gb.colorSpec = detail::gbufferAttachment(GL_COLOR_ATTACHMENT2, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST, width, height);
+    gb.depthStencil = detail::gbufferAttachment(GL_DEPTH_STENCIL_ATTACHMENT, GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, GL_LINEAR, width, height);
+
+    GLuint buffers[3] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2};
+    glDrawBuffers(3, buffers);
+
+    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "[GBuffer] is not a valid framebuffer (incomplete)!" << std::endl;
+        std::cerr.flush();
+        throw std::runtime_error("[GBuffer] is not a valid framebuffer (incomplete)!");
+    }
+
+    /* light buffer, attach color and the depth-stencil texture of the gBuffer */
+    glGenFramebuffers(1, &gb.lightFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, gb.lightFbo);
+
+    gb.light = detail::gbufferAttachment(GL_COLOR_ATTACHMENT0, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, GL_LINEAR, width, height);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, gb.depthStencil, 0);
+
+    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "[GBuffer] light buffer is not a valid framebuffer (incomplete)!" << std::endl;
+        std::cerr.flush();
+        throw std::runtime_error("[GBuffer] light buffer is not a valid framebuffer (incomplete)!");
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    return gb;
+}
+
+std::size_t gbufferMemory(const GBuffer& gb)
+{
+    /* position + normal (RGBA16F), colorSpec (RGBA8), depth-stencil (D24S8), light (RGBA8) */
+    return std::size_t(gb.width) * gb.height * (8 + 8 + 4 + 4 + 4);
+}
+
+void gbufferDelete(const GBuffer& gb)
+{
+    glDeleteTextures(1, &gb.position);
+    glDeleteTextures(1, &gb.normal);
+    glDeleteTextures(1, &gb.colorSpec);
+    glDeleteTextures(1, &gb.depthStencil);
+    glDeleteTextures(1, &gb.light);
+    glDeleteFramebuffers(1, &gb.fbo);
+    glDeleteFramebuffers(1, &gb.lightFbo);
+    glCheckError();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "base.h"
+
+#include <cstddef>
+
+struct GBuffer
+{
+    GLuint fbo = 0;
+    GLuint position = 0;
+    GLuint normal = 0;
+    GLuint colorSpec = 0;
+    GLuint depthStencil = 0;
+
+    /* shaded result of the deferred passes, shares the depth-stencil attachment of the gBuffer */
+    GLuint lightFbo = 0;
+    GLuint light = 0;
+
+    unsigned int width = 0;
+    unsigned int height = 0;
+};
+
+/**
+ * @brief Initializes the geometry buffer used by the deferred passes. Attachment 0 holds positions, attachment 1
+ * normals, attachment 2 color (rgb) and specularity (a); depth and stencil are stored in a combined depth-stencil
+ * texture. The stencil buffer is free for the geometry pass to tag pixels, the deferred passes can then test against
+ * it when drawing into the light buffer.
+ *
+ * @param width GBuffer width.
+ * @param height GBuffer height.
+ *
+ * @return Initialized gbuffer object.
+ */
+GBuffer gbufferCreate(unsigned int width, unsigned int height);
+/**
+ * @brief Computes the video memory used by the attachments of a gbuffer, including the light buffer.
+ *
+ * @param gb GBuffer.
+ *
+ * @return Size in bytes.
+ */
+std::size_t gbufferMemory(const GBuffer& gb);
+
+/**
+ * @brief Cleanup and delete all OpenGL objects of a gbuffer. Has to be called for each gbuffer after it is not used anymore.
+ *
+ * @param gb GBuffer to delete.
+ */
+void gbufferDelete(const GBuffer& gb);
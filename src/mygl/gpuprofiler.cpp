@@ -0,0 +1,237 @@
+#include "gpuprofiler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+namespace detail
+{
+
+unsigned int gpuProfilerPass(GpuProfiler& profiler, const std::string& name)
+{
+    for(unsigned int i = 0; i < profiler.passes.size(); i++)
+    {
+        if(profiler.passes[i].name == name)
+        {
+            return i;
+        }
+    }
+
+    GpuProfilerPass pass;
+    pass.name = name;
+    pass.samples.reserve(GpuProfiler::SAMPLE_COUNT);
+    profiler.passes.push_back(pass);
+
+    return profiler.passes.size() - 1;
+}
+
+void gpuProfilerCollect(GpuProfiler& profiler, GpuProfiler::Frame& frame)
+{
+    frame.pending = false;
+    if(frame.scopeCount == 0)
+    {
+        return;
+    }
+
+    /* GL_QUERY_RESULT blocks until the result arrived, so recorded frames are never dropped */
+    for(unsigned int i = 0; i < frame.scopeCount && !profiler.record; i++)
+    {
+        GLint available = 0;
+        glGetQueryObjectiv(frame.queries[i][1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if(!available)
+        {
+            profiler.dropped++;
+            return;
+        }
+    }
+
+    std::vector<float> ms(profiler.passes.size(), -1.0f);
+    for(unsigned int i = 0; i < frame.scopeCount; i++)
+    {
+        GLuint64 start = 0, end = 0;
+        glGetQueryObjectui64v(frame.queries[i][0], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(frame.queries[i][1], GL_QUERY_RESULT, &end);
+
+        float& passMs = ms[frame.pass[i]];
+        passMs = std::max(passMs, 0.0f) + (end - start) * 1e-6f;
+    }
+
+    for(unsigned int i = 0; i < profiler.passes.size(); i++)
+    {
+        if(ms[i] < 0.0f)
+        {
+            continue;
+        }
+
+        auto& pass = profiler.passes[i];
+        if(pass.samples.size() < GpuProfiler::SAMPLE_COUNT)
+        {
+            pass.samples.push_back(ms[i]);
+        }
+        else
+        {
+            pass.samples[pass.next] = ms[i];
+        }
+        pass.next = (pass.next + 1) % GpuProfiler::SAMPLE_COUNT;
+        pass.latestFrame = frame.index;
+    }
+
+    if(profiler.record)
+    {
+        profiler.records.push_back({frame.index, ms});
+    }
+}
+
+}
+
+GpuProfiler gpuProfilerCreate(unsigned int printInterval)
+{
+    GpuProfiler profiler;
+    profiler.printInterval = printInterval;
+
+    for(auto& frame : profiler.frames)
+    {
+        glGenQueries(2 * GpuProfiler::SCOPE_COUNT, &frame.queries[0][0]);
+    }
+    glCheckError();
+
+    return profiler;
+}
+
+void gpuProfilerBeginFrame(GpuProfiler& profiler)
+{
+    auto& frame = profiler.frames[profiler.frame % GpuProfiler::FRAME_COUNT];
+    if(frame.pending)
+    {
+        detail::gpuProfilerCollect(profiler, frame);
+    }
+
+    frame.scopeCount = 0;
+    frame.index = profiler.frame;
+}
+
+void gpuProfilerBegin(GpuProfiler& profiler, const std::string& name)
+{
+    auto& frame = profiler.frames[profiler.frame % GpuProfiler::FRAME_COUNT];
+    assert(frame.scopeCount < GpuProfiler::SCOPE_COUNT);
+
+    unsigned int scope = frame.scopeCount++;
+    frame.pass[scope] = detail::gpuProfilerPass(profiler, name);
+    glQueryCounter(frame.queries[scope][0], GL_TIMESTAMP);
+
+    profiler.open.push_back(scope);
+}
+
+void gpuProfilerEnd(GpuProfiler& profiler)
+{
+    assert(!profiler.open.empty());
+
+    auto& frame = profiler.frames[profiler.frame % GpuProfiler::FRAME_COUNT];
+    glQueryCounter(frame.queries[profiler.open.back()][1], GL_TIMESTAMP);
+
+    profiler.open.pop_back();
+}
+
+void gpuProfilerEndFrame(GpuProfiler& profiler)
+{
+    assert(profiler.open.empty());
+
+    profiler.frames[profiler.frame % GpuProfiler::FRAME_COUNT].pending = true;
+    profiler.frame++;
+
+    if(profiler.printInterval != 0 && profiler.frame % profiler.printInterval == 0)
+    {
+        gpuProfilerPrint(profiler);
+    }
+}
+
+void gpuProfilerFlush(GpuProfiler& profiler)
+{
+    assert(profiler.open.empty());
+
+    /* oldest frame first, so records stay in frame order */
+    for(unsigned int i = 0; i < GpuProfiler::FRAME_COUNT; i++)
+    {
+        auto& frame = profiler.frames[(profiler.frame + i) % GpuProfiler::FRAME_COUNT];
+        if(frame.pending)
+        {
+            detail::gpuProfilerCollect(profiler, frame);
+        }
+    }
+}
+
+GpuProfilerStats gpuProfilerStats(const GpuProfiler& profiler, const std::string& name)
+{
+    GpuProfilerStats stats;
+
+    for(auto& pass : profiler.passes)
+    {
+        if(pass.name != name || pass.samples.empty())
+        {
+            continue;
+        }
+
+        std::vector<float> sorted = pass.samples;
+        std::sort(sorted.begin(), sorted.end());
+
+        float sum = 0.0f;
+        for(float ms : sorted)
+        {
+            sum += ms;
+        }
+
+        stats.samples = sorted.size();
+        stats.min = sorted.front();
+        stats.avg = sum / sorted.size();
+        stats.p99 = sorted[std::ceil(0.99f * sorted.size()) - 1];
+    }
+
+    return stats;
+}
+
+float gpuProfilerLatest(const GpuProfiler& profiler, const std::string& name)
+{
+    float ms = 0.0f;
+    unsigned int frame = 0;
+    gpuProfilerLatest(profiler, name, ms, frame);
+
+    return ms;
+}
+
+bool gpuProfilerLatest(const GpuProfiler& profiler, const std::string& name, float& ms, unsigned int& frame)
+{
+    for(auto& pass : profiler.passes)
+    {
+        if(pass.name == name && !pass.samples.empty())
+        {
+            ms = pass.samples[(pass.next + pass.samples.size() - 1) % pass.samples.size()];
+            frame = pass.latestFrame;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void gpuProfilerPrint(const GpuProfiler& profiler)
+{
+    std::cout << "[GpuProfiler] frame " << profiler.frame << " (" << profiler.dropped << " frames dropped):" << std::endl;
+
+    for(auto& pass : profiler.passes)
+    {
+        GpuProfilerStats stats = gpuProfilerStats(profiler, pass.name);
+        std::cout << "    " << std::left << std::setw(12) << pass.name << std::right << std::fixed << std::setprecision(3)
+                  << " min " << stats.min << " ms, avg " << stats.avg << " ms, p99 " << stats.p99 << " ms over " << stats.samples << " frames" << std::endl;
+        std::cout << std::defaultfloat;
+    }
+}
+
+void gpuProfilerDelete(const GpuProfiler& profiler)
+{
+    for(auto& frame : profiler.frames)
+    {
+        glDeleteQueries(2 * GpuProfiler::SCOPE_COUNT, &frame.queries[0][0]);
+    }
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "base.h"
+
+#include <string>
+#include <vector>
+
+struct GpuProfilerPass
+{
+    std::string name;
+
+    /* gpu time of the pass in milliseconds for the last SAMPLE_COUNT frames it was drawn in */
+    std::vector<float> samples;
+    unsigned int next = 0;
+
+    /* frame the newest sample was measured in */
+    unsigned int latestFrame = 0;
+};
+
+struct GpuProfilerStats
+{
+    float min = 0.0f;
+    float avg = 0.0f;
+    float p99 = 0.0f;
+    unsigned int samples = 0;
+};
+
+struct GpuProfilerRecord
+{
+    unsigned int frame = 0;
+
+    /* gpu time in milliseconds indexed like GpuProfiler::passes, negative if the pass was not drawn in that frame */
+    std::vector<float> ms;
+};
+
+struct GpuProfiler
+{
+    /* frames in flight before their queries are read back, scopes per frame and length of the rolling window */
+    static constexpr unsigned int FRAME_COUNT = 4;
+    static constexpr unsigned int SCOPE_COUNT = 32;
+    static constexpr unsigned int SAMPLE_COUNT = 240;
+
+    struct Frame
+    {
+        /* start and end timestamp of every scope */
+        GLuint queries[SCOPE_COUNT][2] = {};
+        int pass[SCOPE_COUNT] = {};
+        unsigned int scopeCount = 0;
+        unsigned int index = 0;
+        bool pending = false;
+    };
+
+    std::vector<GpuProfilerPass> passes;
+    Frame frames[FRAME_COUNT];
+
+    /* scopes that are still open, innermost last */
+    std::vector<unsigned int> open;
+
+    unsigned int frame = 0;
+    unsigned int dropped = 0;
+
+    /* print a summary every printInterval frames, 0 disables it */
+    unsigned int printInterval = 0;
+
+    /* keep the results of every frame (for benchmark reports). Read back waits for the GPU instead of dropping frames */
+    bool record = false;
+    std::vector<GpuProfilerRecord> records;
+};
+
+/**
+ * @brief Creates a gpu profiler. Scopes are measured with GL_TIMESTAMP queries that are read back FRAME_COUNT frames
+ * later, so profiling never waits for the GPU.
+ *
+ * @param printInterval Number of frames between printed summaries, 0 to never print.
+ *
+ * @return Initialized gpu profiler.
+ */
+GpuProfiler gpuProfilerCreate(unsigned int printInterval = 0);
+
+/**
+ * @brief Starts a frame. Reads back the results of the frame that used the same queries FRAME_COUNT frames ago. If
+ * they are still not available that frame is dropped instead of waiting.
+ *
+ * @param profiler Gpu profiler.
+ */
+void gpuProfilerBeginFrame(GpuProfiler& profiler);
+
+/**
+ * @brief Opens a named scope. Scopes may be nested, the time of a pass that is opened several times per frame is summed
+ * up.
+ *
+ * @param profiler Gpu profiler.
+ * @param name Name of the pass.
+ */
+void gpuProfilerBegin(GpuProfiler& profiler, const std::string& name);
+
+/**
+ * @brief Closes the innermost open scope.
+ *
+ * @param profiler Gpu profiler.
+ */
+void gpuProfilerEnd(GpuProfiler& profiler);
+
+/**
+ * @brief Ends the frame started with gpuProfilerBeginFrame and prints a summary if the print interval is reached.
+ *
+ * @param profiler Gpu profiler.
+ */
+void gpuProfilerEndFrame(GpuProfiler& profiler);
+
+/**
+ * @brief Waits for the results of all frames that are still in flight and reads them back.
+ *
+ * @param profiler Gpu profiler.
+ */
+void gpuProfilerFlush(GpuProfiler& profiler);
+
+/**
+ * @brief Computes min, average and 99th percentile of the gpu time of a pass over the rolling window.
+ *
+ * @param profiler Gpu profiler.
+ * @param name Name of the pass.
+ *
+ * @return Statistics in milliseconds, all zero if the pass was not measured yet.
+ */
+GpuProfilerStats gpuProfilerStats(const GpuProfiler& profiler, const std::string& name);
+
+/**
+ * @brief Returns the most recent gpu time of a pass.
+ *
+ * @param profiler Gpu profiler.
+ * @param name Name of the pass.
+ *
+ * @return Gpu time in milliseconds of the last frame whose results arrived, zero if the pass was not measured yet.
+ */
+float gpuProfilerLatest(const GpuProfiler& profiler, const std::string& name);
+
+/**
+ * @brief Returns the most recent gpu time of a pass and the frame it was measured in, so callers can tell new results
+ * from ones they have already seen and match them with the state the frame was drawn with.
+ *
+ * @param profiler Gpu profiler.
+ * @param name Name of the pass.
+ * @param ms Gpu time in milliseconds of the last frame whose results arrived.
+ * @param frame Index of that frame, counted by gpuProfilerEndFrame.
+ *
+ * @return False if the pass was not measured yet.
+ */
+bool gpuProfilerLatest(const GpuProfiler& profiler, const std::string& name, float& ms, unsigned int& frame);
+
+/**
+ * @brief Prints the statistics of all passes.
+ *
+ * @param profiler Gpu profiler.
+ */
+void gpuProfilerPrint(const GpuProfiler& profiler);
+
+/**
+ * @brief Delete all queries of a gpu profiler.
+ *
+ * @param profiler Gpu profiler to delete.
+ */
+void gpuProfilerDelete(const GpuProfiler& profiler);
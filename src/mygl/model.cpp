@@ -1,5 +1,8 @@
 #include "model.h"
+#include "registry.h"
+#include "cpuprofiler.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <map>
@@ -72,15 +75,17 @@ struct Index
 
 }
 
-std::map<std::string, Material> materialLoad(const std::string &filepath)
+std::map<std::string, MaterialSource> materialLoad(const std::string &filepath)
 {
+    PROFILE_ZONE("materialLoad");
+
     std::ifstream materialFile(filepath);
     if(!materialFile.is_open())
     {
         throw std::runtime_error("[Model] Couldn't open OBJ file at " + filepath);
     }
 
-    std::map<std::string, Material> materials;
+    std::map<std::string, MaterialSource> materials;
     Material* current = nullptr;
 
     /* consume material commands */
@@ -96,11 +101,11 @@ std::map<std::string, Material> materialLoad(const std::string &filepath)
         /* create new material */
         if(code == "newmtl")
         {
-            Material material;
-            ss >> material.name;
+            MaterialSource source;
+            ss >> source.material.name;
 
-            materials[material.name] = material;
-            current = &materials[material.name];
+            materials[source.material.name] = source;
+            current = &materials[source.material.name].material;
         }
         /* shininess parameter */
         else if(code == "Ns" && current)
@@ -130,30 +135,45 @@ std::map<std::string, Material> materialLoad(const std::string &filepath)
         {
             ss >> current->emission.x >> current->emission.y >> current->emission.z;
         }
+        /* diffuse texture (path in respect to .mtl file) */
+        else if(code == "map_Kd" && current)
+        {
+            std::string file;
+            ss >> file;
+            materials[current->name].diffuseMapPath = filepath.substr(0, filepath.find_last_of("\\/")) + "/" + file;
+        }
     }
 
     return materials;
 }
 
-std::vector<Model> modelLoad(const std::string &filepath)
+ModelFile modelParse(const std::string &filepath)
 {
+    PROFILE_ZONE("modelParse");
+
     std::ifstream objFile(filepath);
     if(!objFile.is_open())
     {
         throw std::runtime_error("[Model] Couldn't open OBJ file at " + filepath);
     }
 
-    /* container for GL related stuff */
-    std::vector<Model> models;
-    std::vector<Vertex> glVertices;
-    std::vector<unsigned int> glIndices;
+    ModelFile file;
 
     /* container for OBJ related stuff */
-    std::map<std::string, Material> materials;
     std::vector<Vector3D> vertices;
     std::vector<Vector3D> normals;
     std::vector<Vector2D> uvs;
 
+    /* the last range of a model ends with it */
+    auto finishModel = [&file]()
+    {
+        if(!file.models.empty() && !file.models.back().ranges.empty())
+        {
+            auto& model = file.models.back();
+            auto& range = model.ranges.back();
+            range.indexCount = model.indices.size() - range.indexOffset;
+        }
+    };
 
     /* consume commonds from obj file */
     std::string line;
@@ -172,22 +192,9 @@ std::vector<Model> modelLoad(const std::string &filepath)
         /* create new object */
         else if(code == "o")
         {
-            if(!models.empty())
-            {
-                Model& model = models.back();
-                model.mesh = meshCreate(glVertices, glIndices);
-
-                if(!model.material.empty())
-                {
-                    auto& material = model.material.back();
-                    material.indexCount = glVertices.size() - material.indexOffset;
-                }
-
-                glVertices.clear();
-                glIndices.clear();
-            }
+            finishModel();
 
-            Model& model = models.emplace_back();
+            ModelSource& model = file.models.emplace_back();
             ss >> model.name;
         }
         /* vertex postion */
@@ -211,14 +218,16 @@ std::vector<Model> modelLoad(const std::string &filepath)
         /* face definition (currently only triangles) */
         else if(code == "f")
         {
+            auto& model = file.models.back();
+
             detail::Index _idx[3];
             ss >> _idx[0] >> _idx[1] >> _idx[2];
 
             for(int i = 0; i < 3; i++)
             {
-                glIndices.emplace_back(glVertices.size());
+                model.indices.emplace_back(model.vertices.size());
 
-                Vertex& vertex = glVertices.emplace_back();
+                Vertex& vertex = model.vertices.emplace_back();
                 vertex.pos = vertices[_idx[i].v - 1];
 
                 if(_idx[i].type == detail::Index::V_VN)
@@ -235,49 +244,94 @@ std::vector<Model> modelLoad(const std::string &filepath)
         /* load material file (path in respect to .obj file) */
         else if(code == "mtllib")
         {
-            std::string file;
-            ss >> file;
-            materials = materialLoad( filepath.substr(0, filepath.find_last_of("\\/")) + "/" + file );
+            std::string materialFile;
+            ss >> materialFile;
+            file.materialPath = filepath.substr(0, filepath.find_last_of("\\/")) + "/" + materialFile;
+            file.materials = materialLoad(file.materialPath);
         }
         /* switch to material for next face definitions */
         else if(code == "usemtl")
         {
-            auto& model = models.back();
-            std::string name;
-            ss >> name;
-
-            if(!model.material.empty())
-            {
-                auto& material = model.material.back();
-                material.indexCount = glVertices.size() - material.indexOffset;
-            }
+            finishModel();
 
-            auto& material = model.material.emplace_back( materials[name] );
-            material.indexOffset = glVertices.size();
+            auto& model = file.models.back();
+            auto& range = model.ranges.emplace_back();
+            ss >> range.material;
+            range.indexOffset = model.indices.size();
         }
     }
 
     /* finnish up last object */
-    Model& model = models.back();
-    model.mesh = meshCreate(glVertices, glIndices);
-    if(!model.material.empty())
+    finishModel();
+
+    return file;
+}
+
+std::vector<Model> modelUpload(const ModelFile& file, Registry& registry)
+{
+    PROFILE_ZONE("modelUpload");
+
+    std::vector<Model> models;
+    for(const auto& source : file.models)
     {
-        auto& material = model.material.back();
-        material.indexCount = glVertices.size() - material.indexOffset;
+        Model& model = models.emplace_back();
+        model.name = source.name;
+        model.mesh = meshCreate(source.vertices, source.indices);
+
+        /* sphere around the bounding box, close enough to estimate the size on screen */
+        if(!source.vertices.empty())
+        {
+            Vector3D min = source.vertices.front().pos;
+            Vector3D max = min;
+            for(const auto& vertex : source.vertices)
+            {
+                min = Vector3D(std::min(min.x, vertex.pos.x), std::min(min.y, vertex.pos.y), std::min(min.z, vertex.pos.z));
+                max = Vector3D(std::max(max.x, vertex.pos.x), std::max(max.y, vertex.pos.y), std::max(max.z, vertex.pos.z));
+            }
+            model.center = 0.5f * (min + max);
+            model.radius = 0.5f * length(max - min);
+        }
+
+        for(const auto& sourceRange : source.ranges)
+        {
+            /* unknown names get a default material, like a missing newmtl did before */
+            auto it = file.materials.find(sourceRange.material);
+            const MaterialSource& material = it != file.materials.end() ? it->second : MaterialSource();
+
+            /* materials are interned by file and name, every model using one shares a single copy */
+            auto& range = model.ranges.emplace_back();
+            range.material = registryMaterial(registry, file.materialPath + ":" + sourceRange.material,
+                                              material.material, material.diffuseMapPath);
+            range.indexOffset = sourceRange.indexOffset;
+            range.indexCount = sourceRange.indexCount;
+        }
     }
 
     return models;
 }
 
-void modelDelete(std::vector<Model> &models)
+std::vector<Model> modelLoad(const std::string &filepath, Registry& registry)
+{
+    PROFILE_ZONE("modelLoad");
+
+    return modelUpload(modelParse(filepath), registry);
+}
+
+void modelDelete(std::vector<Model> &models, Registry& registry)
 {
     for(auto& m : models)
     {
-        meshDelete(m.mesh);
+        modelDelete(m, registry);
     }
 }
 
-void modelDelete(Model &model)
+void modelDelete(Model &model, Registry& registry)
 {
     meshDelete(model.mesh);
+
+    for(const auto& range : model.ranges)
+    {
+        registryMaterialRelease(registry, range.material);
+    }
+    model.ranges.clear();
 }
@@ -2,8 +2,16 @@
 
 #include "mesh.h"
 
+#include <map>
+
+/* owner of the materials and textures models refer to, see registry.h */
+struct Registry;
+
 struct Material
 {
+    /* no diffuseMap */
+    static constexpr unsigned int NO_TEXTURE = ~0u;
+
     std::string name;
 
     Vector3D emission;
@@ -12,6 +20,19 @@ struct Material
     Vector3D specular;
     float shininess;
 
+    /* texture handle in the registry (map_Kd) */
+    unsigned int diffuseMap = NO_TEXTURE;
+
+    /* texture array and layer the diffuse map was packed into by registryBatchTextures */
+    unsigned int diffuseArray = NO_TEXTURE;
+    unsigned int diffuseLayer = 0;
+};
+
+/* indices of a model drawn with one material, the material is shared through the registry */
+struct MaterialRange
+{
+    unsigned int material;
+
     unsigned int indexOffset;
     unsigned int indexCount;
 };
@@ -20,9 +41,73 @@ struct Model
 {
     Mesh mesh;
     std::string name;
-    std::vector<Material> material;
+    std::vector<MaterialRange> ranges;
+
+    /* bounding sphere in model space */
+    Vector3D center;
+    float radius = 0.0f;
+};
+
+/* material as read from the file, the diffuse map is only loaded once the material is used */
+struct MaterialSource
+{
+    Material material;
+    std::string diffuseMapPath;
 };
 
-std::vector<Model> modelLoad(const std::string &filepath);
-void modelDelete(std::vector<Model>& models);
-void modelDelete(Model& model);
+/* object of an OBJ file before anything is uploaded, ranges refer to materials by name */
+struct ModelSource
+{
+    struct Range
+    {
+        std::string material;
+        unsigned int indexOffset = 0;
+        unsigned int indexCount = 0;
+    };
+
+    std::string name;
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<Range> ranges;
+};
+
+/* contents of an OBJ file and its material file */
+struct ModelFile
+{
+    std::string materialPath;
+    std::map<std::string, MaterialSource> materials;
+    std::vector<ModelSource> models;
+};
+
+/**
+ * @brief Reads the materials of a MTL file, does not need an OpenGL context.
+ *
+ * @param filepath Path to the MTL file.
+ *
+ * @return Materials by name, diffuse map paths are relative to the working directory.
+ */
+std::map<std::string, MaterialSource> materialLoad(const std::string& filepath);
+
+/**
+ * @brief Parses an OBJ file and the material file it references, does not need an OpenGL context.
+ *
+ * @param filepath Path to the OBJ file.
+ *
+ * @return Objects and materials of the file.
+ */
+ModelFile modelParse(const std::string& filepath);
+
+/**
+ * @brief Creates the meshes of a parsed OBJ file and acquires its materials from the registry.
+ *
+ * @param file Parsed OBJ file.
+ * @param registry Registry the materials and their textures are shared through.
+ *
+ * @return One model per object of the file.
+ */
+std::vector<Model> modelUpload(const ModelFile& file, Registry& registry);
+
+/* modelUpload(modelParse(filepath), registry) */
+std::vector<Model> modelLoad(const std::string &filepath, Registry& registry);
+void modelDelete(std::vector<Model>& models, Registry& registry);
+void modelDelete(Model& model, Registry& registry);
@@ -0,0 +1,172 @@
+#include "offscreen.h"
+
+#include <cstring>
+#include <iostream>
+
+#ifdef VCPROJ_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+namespace detail
+{
+
+bool offscreenHasExtension(EGLDisplay display, const char* name)
+{
+    const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+    return extensions && std::strstr(extensions, name);
+}
+
+/* Mesa's surfaceless platform needs neither X11/Wayland nor a render node, fall back to the default display */
+EGLDisplay offscreenDisplay()
+{
+    if(offscreenHasExtension(EGL_NO_DISPLAY, "EGL_MESA_platform_surfaceless"))
+    {
+        auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if(getPlatformDisplay)
+        {
+            EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            if(display != EGL_NO_DISPLAY)
+            {
+                return display;
+            }
+        }
+    }
+
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+}
+
+OffscreenContext offscreenCreate(unsigned int width, unsigned int height)
+{
+    OffscreenContext ctx;
+
+    EGLDisplay display = detail::offscreenDisplay();
+    if(display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+    {
+        std::cerr << "[Offscreen] couldn't initialize EGL display" << std::endl;
+        return ctx;
+    }
+    ctx.display = display;
+
+    if(!eglBindAPI(EGL_OPENGL_API))
+    {
+        std::cerr << "[Offscreen] EGL does not support desktop OpenGL" << std::endl;
+        offscreenDelete(ctx);
+        return ctx;
+    }
+
+    /* prefer a config with pbuffer support, without one the context is made current without any surface */
+    EGLint configAttribs[] =
+    {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_DEPTH_SIZE, 24, EGL_STENCIL_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    eglChooseConfig(display, configAttribs, &config, 1, &configCount);
+
+    if(configCount == 0)
+    {
+        configAttribs[1] = 0;
+        eglChooseConfig(display, configAttribs, &config, 1, &configCount);
+    }
+
+    bool surfaceless = detail::offscreenHasExtension(display, "EGL_KHR_surfaceless_context");
+    if(configCount == 0 && !surfaceless)
+    {
+        std::cerr << "[Offscreen] no suitable EGL config" << std::endl;
+        offscreenDelete(ctx);
+        return ctx;
+    }
+
+    if(configCount > 0)
+    {
+        EGLint pbufferAttribs[] = {EGL_WIDTH, EGLint(width), EGL_HEIGHT, EGLint(height), EGL_NONE};
+        EGLSurface surface = eglCreatePbufferSurface(display, config, pbufferAttribs);
+        ctx.surface = surface == EGL_NO_SURFACE ? nullptr : surface;
+    }
+
+    EGLint contextAttribs[] =
+    {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, configCount > 0 ? config : EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttribs);
+    if(context == EGL_NO_CONTEXT)
+    {
+        std::cerr << "[Offscreen] couldn't create OpenGL 3.3 core context" << std::endl;
+        offscreenDelete(ctx);
+        return ctx;
+    }
+    ctx.context = context;
+
+    EGLSurface surface = ctx.surface ? EGLSurface(ctx.surface) : EGL_NO_SURFACE;
+    if(!eglMakeCurrent(display, surface, surface, context))
+    {
+        std::cerr << "[Offscreen] couldn't make context current" << std::endl;
+        offscreenDelete(ctx);
+        return ctx;
+    }
+
+    /*-------------- init glad ----------------*/
+    if(!gladLoadGLLoader((GLADloadproc) eglGetProcAddress))
+    {
+        std::cerr << "Couldn't initialize GLAD" << std::endl;
+        offscreenDelete(ctx);
+        return ctx;
+    }
+
+    std::cout << "[Offscreen] EGL context on " << glGetString(GL_RENDERER) << std::endl;
+    return ctx;
+}
+
+bool offscreenValid(const OffscreenContext& ctx)
+{
+    return ctx.context != nullptr;
+}
+
+void offscreenDelete(OffscreenContext& ctx)
+{
+    if(ctx.display)
+    {
+        eglMakeCurrent(ctx.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if(ctx.context) eglDestroyContext(ctx.display, ctx.context);
+        if(ctx.surface) eglDestroySurface(ctx.display, ctx.surface);
+        eglTerminate(ctx.display);
+    }
+
+    ctx = {};
+}
+
+#else
+
+OffscreenContext offscreenCreate(unsigned int width, unsigned int height)
+{
+    OffscreenContext ctx;
+    ctx.window = windowCreate("offscreen", width, height, false, false);
+
+    return ctx;
+}
+
+bool offscreenValid(const OffscreenContext& ctx)
+{
+    return ctx.window != nullptr;
+}
+
+void offscreenDelete(OffscreenContext& ctx)
+{
+    if(ctx.window)
+    {
+        windowDelete(ctx.window);
+    }
+
+    ctx = {};
+}
+
+#endif
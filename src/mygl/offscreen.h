@@ -0,0 +1,46 @@
+#pragma once
+
+#include "base.h"
+
+/**
+ * OpenGL context without a window, for machines without a display. With VCPROJ_EGL (CMake option, Linux only) the
+ * context is created through EGL on Mesa's surfaceless platform, which also works on llvmpipe without a GPU. Otherwise
+ * a hidden GLFW window is used, which only works without a display if GLFW was built for OSMesa (GLFW_USE_OSMESA).
+ *
+ * There is no usable default framebuffer, everything has to be rendered into a Framebuffer.
+ */
+struct OffscreenContext
+{
+    /* EGLDisplay, EGLSurface and EGLContext, kept opaque so EGL headers are not needed everywhere */
+    void* display = nullptr;
+    void* surface = nullptr;
+    void* context = nullptr;
+
+    GLFWwindow* window = nullptr;
+};
+
+/**
+ * @brief Create an OpenGL 3.3 core context without a window and make it current.
+ *
+ * @param width Width of the pbuffer backing the context (if the platform needs one).
+ * @param height Height of the pbuffer backing the context (if the platform needs one).
+ *
+ * @return Initialized context, check with offscreenValid.
+ */
+OffscreenContext offscreenCreate(unsigned int width, unsigned int height);
+
+/**
+ * @brief Checks whether offscreenCreate succeeded.
+ *
+ * @param ctx Offscreen context.
+ *
+ * @return True if the context exists and is current.
+ */
+bool offscreenValid(const OffscreenContext& ctx);
+
+/**
+ * @brief Delete the offscreen context. Has to be called for each context after it is not used anymore.
+ *
+ * @param ctx Offscreen context to delete.
+ */
+void offscreenDelete(OffscreenContext& ctx);
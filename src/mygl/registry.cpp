@@ -0,0 +1,309 @@
+#include "registry.h"
+
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+namespace detail
+{
+
+/* index of a free slot, the vector grows if there is none */
+template<typename Slot>
+unsigned int registrySlot(std::vector<Slot>& slots, std::vector<unsigned int>& freeSlots)
+{
+    if(!freeSlots.empty())
+    {
+        unsigned int handle = freeSlots.back();
+        freeSlots.pop_back();
+        return handle;
+    }
+
+    slots.emplace_back();
+    return slots.size() - 1;
+}
+
+}
+
+void registryStreamTextures(Registry& registry, std::size_t budget)
+{
+    if(!registry.streaming)
+    {
+        registry.streamer = textureStreamerCreate(budget);
+        registry.streaming = true;
+    }
+    registry.streamer.budget = budget;
+}
+
+unsigned int registryTexture(Registry& registry, const std::string& path)
+{
+    auto it = registry.textureIds.find(path);
+    if(it != registry.textureIds.end())
+    {
+        auto& slot = registry.textures[it->second];
+        slot.refs++;
+        registry.textureShared++;
+        registry.textureBytesSaved += slot.texture.size;
+        return it->second;
+    }
+
+    /* a streamed texture shows a placeholder until it is decoded, a missing file is only reported by the streamer */
+    if(registry.streaming)
+    {
+        unsigned int stream = textureStreamerAdd(registry.streamer, path);
+
+        unsigned int handle = detail::registrySlot(registry.textures, registry.freeTextures);
+        auto& slot = registry.textures[handle];
+        slot.path = path;
+        slot.texture.id = textureStreamerTexture(registry.streamer, stream);
+        slot.stream = stream;
+        slot.refs = 1;
+        registry.textureIds[path] = handle;
+
+        return handle;
+    }
+
+    /* load before taking a slot, a missing file must not leave an empty one behind */
+    Texture texture = textureLoad(path);
+
+    unsigned int handle = detail::registrySlot(registry.textures, registry.freeTextures);
+    auto& slot = registry.textures[handle];
+    slot.path = path;
+    slot.texture = texture;
+    slot.refs = 1;
+    registry.textureIds[path] = handle;
+
+    return handle;
+}
+
+void registryTextureRelease(Registry& registry, unsigned int handle)
+{
+    auto& slot = registry.textures[handle];
+    if(slot.refs == 0)
+    {
+        throw std::runtime_error("[Registry] texture released more often than acquired: " + slot.path);
+    }
+
+    if(--slot.refs == 0)
+    {
+        if(slot.stream != Material::NO_TEXTURE)
+        {
+            textureStreamerRemove(registry.streamer, slot.stream);
+        }
+        else if(slot.array == Material::NO_TEXTURE)
+        {
+            textureDelete(slot.texture);
+        }
+        else if(--registry.arrays[slot.array].refs == 0)
+        {
+            textureArrayDelete(registry.arrays[slot.array].array);
+            registry.arrays[slot.array] = Registry::ArraySlot();
+        }
+        registry.textureIds.erase(slot.path);
+        slot = Registry::TextureSlot();
+        registry.freeTextures.push_back(handle);
+    }
+}
+
+const Texture& registryTextureGet(const Registry& registry, unsigned int handle)
+{
+    return registry.textures[handle].texture;
+}
+
+void registryTextureRequest(Registry& registry, unsigned int handle, float screenSize)
+{
+    const auto& slot = registry.textures[handle];
+    if(slot.stream != Material::NO_TEXTURE)
+    {
+        textureStreamerRequest(registry.streamer, slot.stream, screenSize);
+    }
+}
+
+void registryBatchTextures(Registry& registry)
+{
+    /* textures that can share an array */
+    std::map<std::tuple<unsigned int, unsigned int, GLenum, unsigned int>, std::vector<unsigned int>> groups;
+    for(unsigned int i = 0; i < registry.textures.size(); i++)
+    {
+        const auto& slot = registry.textures[i];
+        if(slot.refs > 0 && slot.array == Material::NO_TEXTURE && slot.stream == Material::NO_TEXTURE)
+        {
+            groups[{slot.texture.width, slot.texture.height, slot.texture.format, slot.texture.levels}].push_back(i);
+        }
+    }
+
+    for(const auto& [key, handles] : groups)
+    {
+        /* the mip chains are read from the texture cache again, the GPU copies are not read back */
+        std::vector<TextureImage> images;
+        for(unsigned int handle : handles)
+        {
+            const auto& texture = registry.textures[handle].texture;
+            images.push_back(textureImageLoad(registry.textures[handle].path, textureCompressed(texture.format)));
+        }
+
+        std::vector<const TextureImage*> layers;
+        std::vector<unsigned int> layerHandles;
+        for(unsigned int i = 0; i < handles.size(); i++)
+        {
+            const auto& texture = registry.textures[handles[i]].texture;
+            const auto& image = images[i];
+
+            /* the file changed since it was loaded, it stays a 2D texture */
+            if(image.format != texture.format || image.levels.size() != texture.levels ||
+               image.levels.front().width != texture.width || image.levels.front().height != texture.height)
+            {
+                continue;
+            }
+            layers.push_back(&image);
+            layerHandles.push_back(handles[i]);
+        }
+        if(layers.empty())
+        {
+            continue;
+        }
+
+        unsigned int arrayIndex = registry.arrays.size();
+        for(unsigned int i = 0; i < registry.arrays.size(); i++)
+        {
+            if(registry.arrays[i].refs == 0)
+            {
+                arrayIndex = i;
+                break;
+            }
+        }
+        if(arrayIndex == registry.arrays.size())
+        {
+            registry.arrays.emplace_back();
+        }
+
+        auto& arraySlot = registry.arrays[arrayIndex];
+        arraySlot.array = textureArrayCreate(layers);
+        arraySlot.refs = layers.size();
+
+        for(unsigned int layer = 0; layer < layerHandles.size(); layer++)
+        {
+            auto& slot = registry.textures[layerHandles[layer]];
+            textureDelete(slot.texture);
+            slot.texture.id = 0;
+            slot.array = arrayIndex;
+            slot.layer = layer;
+        }
+    }
+
+    for(auto& slot : registry.materials)
+    {
+        auto& material = slot.material;
+        if(slot.refs > 0 && material.diffuseMap != Material::NO_TEXTURE)
+        {
+            material.diffuseArray = registry.textures[material.diffuseMap].array;
+            material.diffuseLayer = registry.textures[material.diffuseMap].layer;
+        }
+    }
+}
+
+unsigned int registryMaterial(Registry& registry, const std::string& id, const Material& material, const std::string& diffuseMapPath)
+{
+    auto it = registry.materialIds.find(id);
+    if(it != registry.materialIds.end())
+    {
+        auto& slot = registry.materials[it->second];
+        slot.refs++;
+        registry.materialShared++;
+        registry.materialBytesSaved += sizeof(Material) + slot.material.name.capacity();
+        return it->second;
+    }
+
+    Material stored = material;
+    stored.diffuseMap = diffuseMapPath.empty() ? Material::NO_TEXTURE : registryTexture(registry, diffuseMapPath);
+    if(stored.diffuseMap != Material::NO_TEXTURE)
+    {
+        stored.diffuseArray = registry.textures[stored.diffuseMap].array;
+        stored.diffuseLayer = registry.textures[stored.diffuseMap].layer;
+    }
+
+    unsigned int handle = detail::registrySlot(registry.materials, registry.freeMaterials);
+    auto& slot = registry.materials[handle];
+    slot.id = id;
+    slot.material = stored;
+    slot.refs = 1;
+    registry.materialIds[id] = handle;
+
+    return handle;
+}
+
+void registryMaterialRelease(Registry& registry, unsigned int handle)
+{
+    auto& slot = registry.materials[handle];
+    if(slot.refs == 0)
+    {
+        throw std::runtime_error("[Registry] material released more often than acquired: " + slot.id);
+    }
+
+    if(--slot.refs == 0)
+    {
+        if(slot.material.diffuseMap != Material::NO_TEXTURE)
+        {
+            registryTextureRelease(registry, slot.material.diffuseMap);
+        }
+        registry.materialIds.erase(slot.id);
+        slot = Registry::MaterialSlot();
+        registry.freeMaterials.push_back(handle);
+    }
+}
+
+const Material& registryMaterialGet(const Registry& registry, unsigned int handle)
+{
+    return registry.materials[handle].material;
+}
+
+void registryReport(const Registry& registry)
+{
+    unsigned int arrays = 0;
+    for(const auto& slot : registry.arrays)
+    {
+        arrays += slot.refs > 0;
+    }
+
+    std::cout << "[Registry] " << registry.textureIds.size() << " textures in " << arrays << " arrays ("
+              << registry.textureShared << " shared, "
+              << registry.textureBytesSaved / 1024 << " KiB of uploads saved), " << registry.materialIds.size()
+              << " materials (" << registry.materialShared << " shared, " << registry.materialBytesSaved << " bytes saved)"
+              << std::endl;
+
+    if(registry.streaming)
+    {
+        textureStreamerReport(registry.streamer);
+    }
+}
+
+void registryDelete(Registry& registry)
+{
+    for(auto& slot : registry.textures)
+    {
+        if(slot.refs > 0 && slot.array == Material::NO_TEXTURE && slot.stream == Material::NO_TEXTURE)
+        {
+            textureDelete(slot.texture);
+        }
+    }
+    if(registry.streaming)
+    {
+        textureStreamerDelete(registry.streamer);
+        registry.streaming = false;
+    }
+    for(auto& slot : registry.arrays)
+    {
+        if(slot.refs > 0)
+        {
+            textureArrayDelete(slot.array);
+        }
+    }
+
+    registry.textures.clear();
+    registry.arrays.clear();
+    registry.textureIds.clear();
+    registry.freeTextures.clear();
+    registry.materials.clear();
+    registry.materialIds.clear();
+    registry.freeMaterials.clear();
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "model.h"
+#include "texture.h"
+#include "texturearray.h"
+#include "texturestreamer.h"
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* shared GPU resources. Textures are interned by path and materials by id, users hold small handles and every
+ * acquire has to be matched by a release. Unused slots are reused by later acquires */
+struct Registry
+{
+    struct TextureSlot
+    {
+        std::string path;
+        Texture texture;
+        unsigned int refs = 0;
+
+        /* once batched the texture is a layer of arrays[array] and texture.id is 0 */
+        unsigned int array = Material::NO_TEXTURE;
+        unsigned int layer = 0;
+
+        /* handle in the streamer if the texture is streamed, texture.id is then the streamer's texture */
+        unsigned int stream = Material::NO_TEXTURE;
+    };
+
+    struct ArraySlot
+    {
+        TextureArray array;
+        /* layers that are still referenced */
+        unsigned int refs = 0;
+    };
+
+    struct MaterialSlot
+    {
+        std::string id;
+        Material material;
+        unsigned int refs = 0;
+    };
+
+    std::vector<TextureSlot> textures;
+    std::unordered_map<std::string, unsigned int> textureIds;
+    std::vector<unsigned int> freeTextures;
+
+    std::vector<ArraySlot> arrays;
+
+    /* textures acquired while streaming are decoded in the background and keep only the mip levels they need */
+    bool streaming = false;
+    TextureStreamer streamer;
+
+    std::vector<MaterialSlot> materials;
+    std::unordered_map<std::string, unsigned int> materialIds;
+    std::vector<unsigned int> freeMaterials;
+
+    /* acquires that found the resource already loaded and the bytes this saved */
+    unsigned int textureShared = 0;
+    unsigned int materialShared = 0;
+    std::size_t textureBytesSaved = 0;
+    std::size_t materialBytesSaved = 0;
+};
+
+/**
+ * @brief Streams all textures acquired from now on through a texture streamer instead of loading them (see
+ * textureStreamerCreate). Streamed textures stay plain 2D textures, they are never packed into arrays.
+ *
+ * @param registry Registry.
+ * @param budget Maximum bytes of resident mip levels of the streamed textures.
+ */
+void registryStreamTextures(Registry& registry, std::size_t budget);
+
+/**
+ * @brief Acquires the texture at path, it is only loaded (see textureLoad) or added to the streamer by the first
+ * acquire.
+ *
+ * @param registry Registry.
+ * @param path Path to texture file, used as key.
+ *
+ * @return Handle of the texture.
+ */
+unsigned int registryTexture(Registry& registry, const std::string& path);
+
+/**
+ * @brief Releases a texture handle, the texture is deleted with its last reference.
+ *
+ * @param registry Registry.
+ * @param handle Handle returned by registryTexture.
+ */
+void registryTextureRelease(Registry& registry, unsigned int handle);
+
+/**
+ * @brief Get the texture of a handle.
+ *
+ * @param registry Registry.
+ * @param handle Handle returned by registryTexture.
+ *
+ * @return Texture.
+ */
+const Texture& registryTextureGet(const Registry& registry, unsigned int handle);
+
+/**
+ * @brief Requests a streamed texture for this frame (see textureStreamerRequest), does nothing for loaded textures.
+ *
+ * @param registry Registry.
+ * @param handle Handle returned by registryTexture.
+ * @param screenSize Size of the texture on screen in pixels.
+ */
+void registryTextureRequest(Registry& registry, unsigned int handle, float screenSize);
+
+/**
+ * @brief Packs all loaded textures that are not batched yet into texture arrays, one array per size, format and mip count,
+ * and points the materials using them to their array layer. Textures acquired later stay plain 2D textures until the
+ * next call.
+ *
+ * @param registry Registry.
+ */
+void registryBatchTextures(Registry& registry);
+
+/**
+ * @brief Acquires the material with the given id. The first acquire stores the material and acquires its diffuse map,
+ * later ones share it and ignore the passed values.
+ *
+ * @param registry Registry.
+ * @param id Unique id of the material, e.g. material file and name.
+ * @param material Material properties.
+ * @param diffuseMapPath Path to the diffuse map, empty for none.
+ *
+ * @return Handle of the material.
+ */
+unsigned int registryMaterial(Registry& registry, const std::string& id, const Material& material, const std::string& diffuseMapPath = "");
+
+/**
+ * @brief Releases a material handle, the material and its diffuse map reference are dropped with its last reference.
+ *
+ * @param registry Registry.
+ * @param handle Handle returned by registryMaterial.
+ */
+void registryMaterialRelease(Registry& registry, unsigned int handle);
+
+/**
+ * @brief Get the material of a handle.
+ *
+ * @param registry Registry.
+ * @param handle Handle returned by registryMaterial.
+ *
+ * @return Material.
+ */
+const Material& registryMaterialGet(const Registry& registry, unsigned int handle);
+
+/**
+ * @brief Prints the number of shared textures and materials and the memory sharing saved.
+ *
+ * @param registry Registry.
+ */
+void registryReport(const Registry& registry);
+
+/**
+ * @brief Deletes all textures and texture arrays that are still referenced, stops streaming and clears the registry.
+ *
+ * @param registry Registry to delete.
+ */
+void registryDelete(Registry& registry);
@@ -0,0 +1,220 @@
+#include "screenshot.h"
+
+#include "cpuprofiler.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <stb_image/stb_image_write.h>
+
+struct ScreenshotJob
+{
+    std::string path;
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;
+};
+
+struct ScreenshotWorker
+{
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<ScreenshotJob> jobs;
+    bool stop = false;
+
+    std::thread thread;
+};
+
+namespace detail
+{
+
+void screenshotWorkerRun(ScreenshotWorker& worker)
+{
+    PROFILE_THREAD("screenshot");
+
+    while(true)
+    {
+        ScreenshotJob job;
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.wake.wait(lock, [&] { return worker.stop || !worker.jobs.empty(); });
+
+            /* jobs that were queued before stopping are still written */
+            if(worker.jobs.empty())
+            {
+                return;
+            }
+            job = std::move(worker.jobs.front());
+            worker.jobs.pop_front();
+        }
+
+        PROFILE_ZONE("screenshotEncode");
+        if(stbi_write_png(job.path.c_str(), job.width, job.height, 4, job.pixels.data(), job.width * 4))
+        {
+            std::cout << "[Screenshot] wrote " << job.path << std::endl;
+        }
+        else
+        {
+            std::cerr << "[Screenshot] couldn't write " << job.path << std::endl;
+        }
+    }
+}
+
+/* copies the pixels out of the pixel buffer and queues them for encoding, the fence has to be signaled */
+void screenshotFinish(ScreenshotQueue& queue, ScreenshotQueue::Readback& readback)
+{
+    ScreenshotJob job;
+    job.path = readback.path;
+    job.width = readback.width;
+    job.height = readback.height;
+    job.pixels.resize(std::size_t(readback.width) * readback.height * 4);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+    void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, job.pixels.size(), GL_MAP_READ_BIT);
+    if(data)
+    {
+        std::memcpy(job.pixels.data(), data, job.pixels.size());
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glCheckError();
+
+    glDeleteSync(readback.fence);
+    readback.fence = nullptr;
+
+    if(!data)
+    {
+        std::cerr << "[Screenshot] couldn't map pixel buffer for " << readback.path << std::endl;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue.worker->mutex);
+        queue.worker->jobs.push_back(std::move(job));
+    }
+    queue.worker->wake.notify_one();
+}
+
+}
+
+ScreenshotQueue screenshotQueueCreate()
+{
+    ScreenshotQueue queue;
+    for(auto& readback : queue.readbacks)
+    {
+        glGenBuffers(1, &readback.pbo);
+    }
+    glCheckError();
+
+    /* stb keeps this flag in a global. It is only set here, before the encoder thread starts, and by screenshotToPNG
+     * (to the same value), so the encoder never sees it change */
+    stbi_flip_vertically_on_write(true);
+
+    queue.worker = new ScreenshotWorker();
+    queue.worker->thread = std::thread(detail::screenshotWorkerRun, std::ref(*queue.worker));
+
+    return queue;
+}
+
+bool screenshotQueueRequest(ScreenshotQueue& queue, const std::string& filepath, GLuint fbo)
+{
+    PROFILE_ZONE("screenshotRequest");
+
+    ScreenshotQueue::Readback* readback = nullptr;
+    for(auto& r : queue.readbacks)
+    {
+        if(!r.fence)
+        {
+            readback = &r;
+            break;
+        }
+    }
+
+    if(!readback)
+    {
+        std::cerr << "[Screenshot] too many screenshots in flight, skipping " << filepath << std::endl;
+        return false;
+    }
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    readback->width = viewport[2];
+    readback->height = viewport[3];
+    readback->frame = queue.frame;
+    readback->path = filepath;
+
+    GLint readFbo = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFbo);
+
+    /* with a pixel pack buffer bound glReadPixels only queues the copy and returns immediately */
+    GLsizeiptr size = GLsizeiptr(readback->width) * readback->height * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->pbo);
+    if(size != readback->size)
+    {
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        readback->size = size;
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glReadBuffer(fbo == 0 ? GL_FRONT : GL_COLOR_ATTACHMENT0);
+    glReadPixels(viewport[0], viewport[1], readback->width, readback->height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    readback->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFbo);
+    glCheckError();
+
+    return true;
+}
+
+void screenshotQueuePoll(ScreenshotQueue& queue)
+{
+    for(auto& readback : queue.readbacks)
+    {
+        /* requested this frame, the copy has not even been submitted yet */
+        if(!readback.fence || readback.frame == queue.frame)
+        {
+            continue;
+        }
+
+        GLenum status = glClientWaitSync(readback.fence, 0, 0);
+        if(status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+        {
+            detail::screenshotFinish(queue, readback);
+        }
+    }
+
+    queue.frame++;
+}
+
+void screenshotQueueDelete(ScreenshotQueue& queue)
+{
+    /* waiting is fine here, nothing is drawn anymore */
+    for(auto& readback : queue.readbacks)
+    {
+        if(readback.fence)
+        {
+            glClientWaitSync(readback.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+            detail::screenshotFinish(queue, readback);
+        }
+        glDeleteBuffers(1, &readback.pbo);
+    }
+
+    if(queue.worker)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queue.worker->mutex);
+            queue.worker->stop = true;
+        }
+        queue.worker->wake.notify_one();
+        queue.worker->thread.join();
+
+        delete queue.worker;
+        queue.worker = nullptr;
+    }
+}
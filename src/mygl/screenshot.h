@@ -0,0 +1,65 @@
+#pragma once
+
+#include "base.h"
+
+#include <string>
+
+/* png encoder thread and its job queue, only known to screenshot.cpp */
+struct ScreenshotWorker;
+
+struct ScreenshotQueue
+{
+    /* readbacks that can be in flight at once, further requests are refused until one finished */
+    static constexpr unsigned int READBACK_COUNT = 4;
+
+    struct Readback
+    {
+        GLuint pbo = 0;
+        GLsizeiptr size = 0;
+        GLsync fence = nullptr;
+
+        int width = 0;
+        int height = 0;
+        unsigned int frame = 0;
+        std::string path;
+    };
+
+    Readback readbacks[READBACK_COUNT];
+    unsigned int frame = 0;
+
+    ScreenshotWorker* worker = nullptr;
+};
+
+/**
+ * @brief Creates the pixel buffers for asynchronous screenshots and starts the png encoder thread.
+ *
+ * @return Initialized screenshot queue.
+ */
+ScreenshotQueue screenshotQueueCreate();
+
+/**
+ * @brief Starts reading back the current viewport into a pixel buffer without waiting for the GPU. The pixels are
+ * fetched by screenshotQueuePoll once the copy finished and written as PNG on the encoder thread.
+ *
+ * @param queue Screenshot queue.
+ * @param filepath Path to output image.
+ * @param fbo Framebuffer to read, 0 reads the front buffer of the window, otherwise its first color attachment.
+ *
+ * @return False if all readbacks are still in flight.
+ */
+bool screenshotQueueRequest(ScreenshotQueue& queue, const std::string& filepath, GLuint fbo = 0);
+
+/**
+ * @brief Hands finished readbacks to the encoder thread. Has to be called once per frame, readbacks are mapped at the
+ * earliest one frame after their request and only if their fence signaled, so this never waits for the GPU.
+ *
+ * @param queue Screenshot queue.
+ */
+void screenshotQueuePoll(ScreenshotQueue& queue);
+
+/**
+ * @brief Waits for all pending screenshots to be written, stops the encoder thread and deletes the pixel buffers.
+ *
+ * @param queue Screenshot queue to delete.
+ */
+void screenshotQueueDelete(ScreenshotQueue& queue);
@@ -1,4 +1,5 @@
 #include "shader.h"
+#include "cpuprofiler.h"
 
 #include <fstream>
 #include <sstream>
@@ -61,6 +62,8 @@ namespace detail
 
 ShaderProgram shaderCreate(const std::string &vertexSource, const std::string &fragmentSource)
 {
+    PROFILE_ZONE("shaderCreate");
+
     ShaderProgram program{glCreateProgram(), glCreateShader(GL_VERTEX_SHADER), glCreateShader(GL_FRAGMENT_SHADER)};
 
     if(!program._vertexID || !program._fragmentID || !program.id)
@@ -83,6 +86,8 @@ ShaderProgram shaderCreate(const std::string &vertexSource, const std::string &f
 
 ShaderProgram shaderLoad(const std::string &vertexPath, const std::string &fragmentPath)
 {
+    PROFILE_ZONE("shaderLoad");
+
     std::ifstream vertexFile(vertexPath);
     std::ifstream fragmentFile(fragmentPath);
 
@@ -109,12 +114,58 @@ ShaderProgram shaderLoad(const std::string &vertexPath, const std::string &fragm
     return shaderCreate(vertexSourceBuffer.str(), fragmentSourceBuffer.str());
 }
 
+ShaderProgram shaderCreateCompute(const std::string &computeSource)
+{
+    PROFILE_ZONE("shaderCreateCompute");
+
+    ShaderProgram program;
+    program.id = glCreateProgram();
+    program._computeID = glCreateShader(GL_COMPUTE_SHADER);
+
+    if(!program._computeID || !program.id)
+    {
+        std::cerr << "[Shader] Couldn't create compute shader program!" << std::endl;
+        std::cerr.flush();
+        throw std::runtime_error("[Shader] Couldn't create compute shader program!");
+    }
+
+    detail::compile(program._computeID, computeSource.c_str(), computeSource.size());
+    glAttachShader(program.id, program._computeID);
+
+    detail::link(program.id);
+
+    return program;
+}
+
+ShaderProgram shaderLoadCompute(const std::string &computePath)
+{
+    PROFILE_ZONE("shaderLoadCompute");
+
+    std::ifstream computeFile(computePath);
+
+    if(!computeFile.is_open())
+    {
+        std::cerr << "[Shader] Couldn't open compute shader file at " << computePath << std::endl;
+        std::cerr.flush();
+        throw std::runtime_error("[Shader] Couldn't open compute shader file at " + computePath);
+    }
+
+    std::stringstream computeSourceBuffer;
+    computeSourceBuffer << computeFile.rdbuf();
+
+    return shaderCreateCompute(computeSourceBuffer.str());
+}
+
 void shaderDelete(const ShaderProgram &program)
 {
-    glDetachShader(program.id, program._vertexID);
-    glDetachShader(program.id, program._fragmentID);
-    glDeleteShader(program._vertexID);
-    glDeleteShader(program._fragmentID);
+    for(GLuint shader : {program._vertexID, program._fragmentID, program._computeID})
+    {
+        if(shader)
+        {
+            glDetachShader(program.id, shader);
+            glDeleteShader(shader);
+        }
+    }
 
     glDeleteProgram(program.id);
 }
@@ -138,18 +189,36 @@ GLint uniform_index(ShaderProgram &shader, const std::string &name)
 
 }
 
+void shaderUniform(ShaderProgram &shader, const std::string &name, const Matrix3D& value)
+{
+    GLint index = detail::uniform_index(shader, name);
+    glUniformMatrix3fv(index, 1, GL_FALSE, value.ptr());
+}
+
 void shaderUniform(ShaderProgram &shader, const std::string &name, const Matrix4D& value)
 {
     GLint index = detail::uniform_index(shader, name);
     glUniformMatrix4fv(index, 1, GL_FALSE, value.ptr());
 }
 
+void shaderUniform(ShaderProgram &shader, const std::string &name, const Affine3D& value)
+{
+    GLint index = detail::uniform_index(shader, name);
+    glUniformMatrix3x4fv(index, 1, GL_FALSE, value.ptr());
+}
+
 void shaderUniform(ShaderProgram &shader, const std::string &name, int value)
 {
     GLint index = detail::uniform_index(shader, name);
     glUniform1i(index, value);
 }
 
+void shaderUniform(ShaderProgram &shader, const std::string &name, const Vector2D& vec)
+{
+    GLint index = detail::uniform_index(shader, name);
+    glUniform2f(index, vec.x, vec.y);
+}
+
 void shaderUniform(ShaderProgram &shader, const std::string &name, const Vector3D& vec)
 {
     GLint index = detail::uniform_index(shader, name);
@@ -168,3 +237,23 @@ void shaderUniform(ShaderProgram &shader, const std::string &name, float value)
     GLint index = detail::uniform_index(shader, name);
     glUniform1f(index, value);
 }
+
+void shaderUniform(ShaderProgram &shader, const std::string &name, const int* values, unsigned int count)
+{
+    GLint index = detail::uniform_index(shader, name);
+    glUniform1iv(index, count, values);
+}
+
+void shaderUniform(ShaderProgram &shader, const std::string &name, const float* values, unsigned int count)
+{
+    GLint index = detail::uniform_index(shader, name);
+    glUniform1fv(index, count, values);
+}
+
+void shaderUniform(ShaderProgram &shader, const std::string &name, const Vector3D* values, unsigned int count)
+{
+    static_assert(sizeof(Vector3D) == 3 * sizeof(float), "Vector3D has to be three tightly packed floats");
+
+    GLint index = detail::uniform_index(shader, name);
+    glUniform3fv(index, count, &values[0].x);
+}
@@ -7,6 +7,7 @@ struct ShaderProgram
     GLuint id = 0;
     GLuint _vertexID = 0;
     GLuint _fragmentID = 0;
+    GLuint _computeID = 0;
 };
 
 /**
@@ -29,6 +30,24 @@ ShaderProgram shaderLoad(const std::string& vertexPath, const std::string& fragm
  */
 ShaderProgram shaderCreate(const std::string& vertexSource, const std::string& fragmentSource);
 
+/**
+ * @brief Function to load a compute shader from file and compile and link it to create a shader program.
+ *
+ * @param computePath Path to compute shader file.
+ *
+ * @return Shader program.
+ */
+ShaderProgram shaderLoadCompute(const std::string& computePath);
+
+/**
+ * @brief Function to compile and link a compute shader source string to create a shader program.
+ *
+ * @param computeSource Source string holding compute shader code.
+ *
+ * @return Shader program.
+ */
+ShaderProgram shaderCreateCompute(const std::string& computeSource);
+
 /**
  * @brief Cleanup and delete all shaders of a shader program and the program itself. Has to be called for each shader program after it is not used anymore.
  *
@@ -36,6 +55,15 @@ ShaderProgram shaderCreate(const std::string& vertexSource, const std::string& f
  */
 void shaderDelete(const ShaderProgram& program);
 
+/**
+ * @brief Function to set uniform in shader program.
+ *
+ * @param shader Shader program.
+ * @param name Uniform naem.
+ * @param value Value to which the uniform should be set.
+ */
+void shaderUniform(ShaderProgram& shader, const std::string& name, const Matrix3D& value);
+
 /**
  * @brief Function to set uniform in shader program.
  *
@@ -45,6 +73,25 @@ void shaderDelete(const ShaderProgram& program);
  */
 void shaderUniform(ShaderProgram& shader, const std::string& name, const Matrix4D& value);
 
+/**
+ * @brief Function to set a mat3x4 uniform in shader program. The rows of the transformation become the columns of the
+ * uniform, so vec4(p, 1.0) * uniform transforms a point.
+ *
+ * @param shader Shader program.
+ * @param name Uniform name.
+ * @param value Value to which the uniform should be set.
+ */
+void shaderUniform(ShaderProgram& shader, const std::string& name, const Affine3D& value);
+
+/**
+ * @brief Function to set uniform in shader program.
+ *
+ * @param shader Shader program.
+ * @param name Uniform naem.
+ * @param value Value to which the uniform should be set.
+ */
+void shaderUniform(ShaderProgram& shader, const std::string& name, const Vector2D& vec);
+
 /**
  * @brief Function to set uniform in shader program.
  *
@@ -80,3 +127,33 @@ void shaderUniform(ShaderProgram& shader, const std::string& name, int value);
  * @param value Value to which the uniform should be set.
  */
 void shaderUniform(ShaderProgram& shader, const std::string& name, float value);
+
+/**
+ * @brief Function to set uniform array in shader program.
+ *
+ * @param shader Shader program.
+ * @param name Uniform name.
+ * @param values Values to which the first count array elements should be set.
+ * @param count Number of elements.
+ */
+void shaderUniform(ShaderProgram& shader, const std::string& name, const int* values, unsigned int count);
+
+/**
+ * @brief Function to set uniform array in shader program.
+ *
+ * @param shader Shader program.
+ * @param name Uniform name.
+ * @param values Values to which the first count array elements should be set.
+ * @param count Number of elements.
+ */
+void shaderUniform(ShaderProgram& shader, const std::string& name, const float* values, unsigned int count);
+
+/**
+ * @brief Function to set uniform array in shader program.
+ *
+ * @param shader Shader program.
+ * @param name Uniform name.
+ * @param values Values to which the first count array elements should be set.
+ * @param count Number of elements.
+ */
+void shaderUniform(ShaderProgram& shader, const std::string& name, const Vector3D* values, unsigned int count);
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Bounded lock-free queue for exactly one producer and one consumer thread. The producer only writes tail, the consumer
+ * only writes head, so neither ever waits for the other.
+ */
+template<typename T, unsigned int N>
+struct SpscQueue
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "capacity has to be a power of two");
+    static constexpr unsigned int CAPACITY = N;
+
+    T items[N] = {};
+
+    /* counters only grow, the slot is the counter modulo N. Kept on separate cache lines to avoid false sharing */
+    alignas(64) std::atomic<std::uint64_t> head{0};
+    alignas(64) std::atomic<std::uint64_t> tail{0};
+};
+
+/**
+ * @brief Appends an item. Must only be called from the producer thread.
+ *
+ * @param queue Queue.
+ * @param item Item to append.
+ *
+ * @return False if the queue is full, the item is not added then.
+ */
+template<typename T, unsigned int N>
+bool spscPush(SpscQueue<T, N>& queue, const T& item)
+{
+    std::uint64_t tail = queue.tail.load(std::memory_order_relaxed);
+    if(tail - queue.head.load(std::memory_order_acquire) == N)
+    {
+        return false;
+    }
+
+    queue.items[tail % N] = item;
+    queue.tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Removes the oldest item. Must only be called from the consumer thread.
+ *
+ * @param queue Queue.
+ * @param item Receives the removed item.
+ *
+ * @return False if the queue is empty.
+ */
+template<typename T, unsigned int N>
+bool spscPop(SpscQueue<T, N>& queue, T& item)
+{
+    std::uint64_t head = queue.head.load(std::memory_order_relaxed);
+    if(head == queue.tail.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    item = queue.items[head % N];
+    queue.head.store(head + 1, std::memory_order_release);
+    return true;
+}
@@ -1,16 +1,131 @@
 #include "texture.h"
+#include "blockcompress.h"
+#include "cpuprofiler.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <stdexcept>
 #include <iostream>
+#include <vector>
 
 #include <stb_image/stb_image.h>
+#include <stb_image/stb_image_resize.h>
 
-Texture textureLoad(const std::string &path)
+namespace detail
 {
+
+/* header of a .vctex cache file, followed by width, height, size and data of each level */
+struct TextureCacheHeader
+{
+    char magic[4] = {'V', 'C', 'T', 'X'};
+    std::uint32_t version = 1;
+    std::uint64_t sourceSize = 0;
+    std::int64_t sourceTime = 0;
+    std::uint32_t format = 0;
+    std::uint32_t levels = 0;
+};
+
+/* size and modification time of the source, a cache written for other values is stale */
+bool textureSourceStamp(const std::string& path, TextureCacheHeader& header)
+{
+    std::error_code error;
+    auto size = std::filesystem::file_size(path, error);
+    if(error)
+    {
+        return false;
+    }
+    auto time = std::filesystem::last_write_time(path, error);
+    if(error)
+    {
+        return false;
+    }
+
+    header.sourceSize = size;
+    header.sourceTime = time.time_since_epoch().count();
+    return true;
+}
+
+bool textureCacheRead(const std::string& cachePath, const TextureCacheHeader& expected, bool compress, TextureImage& image)
+{
+    std::ifstream file(cachePath, std::ios::binary);
+    if(!file.is_open())
+    {
+        return false;
+    }
+
+    TextureCacheHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if(!file || std::memcmp(header.magic, expected.magic, 4) != 0 || header.version != expected.version ||
+       header.sourceSize != expected.sourceSize || header.sourceTime != expected.sourceTime ||
+       textureCompressed(header.format) != compress || header.levels == 0)
+    {
+        return false;
+    }
+
+    image.format = header.format;
+    image.levels.resize(header.levels);
+    for(auto& level : image.levels)
+    {
+        std::uint32_t info[3] = {0, 0, 0};
+        file.read(reinterpret_cast<char*>(info), sizeof(info));
+        if(!file)
+        {
+            return false;
+        }
+        level.width = info[0];
+        level.height = info[1];
+        level.data.resize(info[2]);
+        file.read(reinterpret_cast<char*>(level.data.data()), level.data.size());
+    }
+
+    return bool(file);
+}
+
+void textureCacheWrite(const std::string& cachePath, const TextureCacheHeader& stamp, const TextureImage& image)
+{
+    TextureCacheHeader header = stamp;
+    header.format = image.format;
+    header.levels = image.levels.size();
+
+    /* written under a temporary name first, a crash never leaves a truncated cache behind */
+    std::string tmpPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if(!file.is_open())
+        {
+            std::cerr << "[Texture] couldn't write cache " << cachePath << std::endl;
+            return;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for(const auto& level : image.levels)
+        {
+            std::uint32_t info[3] = {level.width, level.height, std::uint32_t(level.data.size())};
+            file.write(reinterpret_cast<const char*>(info), sizeof(info));
+            file.write(reinterpret_cast<const char*>(level.data.data()), level.data.size());
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tmpPath, cachePath, error);
+    if(error)
+    {
+        std::cerr << "[Texture] couldn't write cache " << cachePath << ": " << error.message() << std::endl;
+    }
+}
+
+/* decodes the file, builds the mip chain and compresses every level */
+TextureImage textureBuild(const std::string& path, bool compress)
+{
+    PROFILE_ZONE("textureBuild");
+
     int width = 0, height = 0, components = 0;
 
-    /* flip image to match opengl's texture coordinates */
-    stbi_set_flip_vertically_on_load(true);
+    /* flip image to match opengl's texture coordinates, per thread since images are also decoded by the streamer */
+    stbi_set_flip_vertically_on_load_thread(true);
 
     /* load image */
     unsigned char* data = stbi_load(path.c_str(), &width, &height, &components, 4);
@@ -21,23 +136,160 @@ Texture textureLoad(const std::string &path)
         throw std::runtime_error("[Texture] couldn't load image file " + path);
     }
 
+    /* mip chain down to 1x1, every level is filtered from the one above */
+    std::vector<TextureLevel> rgba;
+    {
+        auto& base = rgba.emplace_back();
+        base.width = width;
+        base.height = height;
+        base.data.assign(data, data + std::size_t(width) * height * 4);
+    }
+    stbi_image_free(data);
+
+    while(rgba.back().width > 1 || rgba.back().height > 1)
+    {
+        const auto& src = rgba.back();
+        TextureLevel dst;
+        dst.width = std::max(1u, src.width / 2);
+        dst.height = std::max(1u, src.height / 2);
+        dst.data.resize(std::size_t(dst.width) * dst.height * 4);
+
+        /* color maps are sRGB encoded, averaging has to happen in linear space */
+        stbir_resize_uint8_srgb(src.data.data(), src.width, src.height, 0, dst.data.data(), dst.width, dst.height, 0, 4, 3, 0);
+        rgba.push_back(std::move(dst));
+    }
+
+    TextureImage image;
+    if(!compress)
+    {
+        image.format = GL_RGBA8;
+        image.levels = std::move(rgba);
+        return image;
+    }
+
+    /* alpha is only worth the doubled size if some pixel is not opaque */
+    bool opaque = true;
+    const auto& base = rgba.front().data;
+    for(std::size_t i = 3; i < base.size() && opaque; i += 4)
+    {
+        opaque = base[i] == 255;
+    }
+
+    PROFILE_ZONE("textureCompress");
+    image.format = opaque ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    for(const auto& src : rgba)
+    {
+        auto& level = image.levels.emplace_back();
+        level.width = src.width;
+        level.height = src.height;
+        level.data.resize(blockCompressedSize(src.width, src.height, opaque ? BC1_BLOCK_SIZE : BC3_BLOCK_SIZE));
+
+        if(opaque)
+        {
+            blockCompressBC1(src.data.data(), src.width, src.height, level.data.data());
+        }
+        else
+        {
+            blockCompressBC3(src.data.data(), src.width, src.height, level.data.data());
+        }
+    }
+
+    return image;
+}
+
+}
+
+bool textureCompressed(GLenum format)
+{
+    return format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+}
+
+void textureSetAnisotropy(GLenum target)
+{
+    static float maxAnisotropy = -1.0f;
+    if(maxAnisotropy < 0.0f)
+    {
+        maxAnisotropy = 1.0f;
+        if(GLAD_GL_ARB_texture_filter_anisotropic || GLAD_GL_EXT_texture_filter_anisotropic)
+        {
+            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxAnisotropy);
+            maxAnisotropy = std::min(maxAnisotropy, 16.0f);
+        }
+    }
+
+    if(maxAnisotropy > 1.0f)
+    {
+        glTexParameterf(target, GL_TEXTURE_MAX_ANISOTROPY, maxAnisotropy);
+    }
+}
+
+TextureImage textureImageLoad(const std::string& path, bool compress)
+{
+    PROFILE_ZONE("textureImageLoad");
+
+    detail::TextureCacheHeader stamp;
+    bool cacheable = detail::textureSourceStamp(path, stamp);
+    std::string cachePath = path + ".vctex";
+
+    TextureImage image;
+    if(!cacheable || !detail::textureCacheRead(cachePath, stamp, compress, image))
+    {
+        image = detail::textureBuild(path, compress);
+        if(cacheable)
+        {
+            detail::textureCacheWrite(cachePath, stamp, image);
+        }
+    }
+
+    return image;
+}
+
+void textureUploadLevel(const TextureImage& image, unsigned int level, const void* data)
+{
+    const auto& l = image.levels[level];
+    if(textureCompressed(image.format))
+    {
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, image.format, l.width, l.height, 0, l.data.size(), data);
+    }
+    else
+    {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, l.width, l.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    }
+}
+
+Texture textureLoad(const std::string &path, bool compress)
+{
+    PROFILE_ZONE("textureLoad");
+
+    TextureImage image = textureImageLoad(path, compress && GLAD_GL_EXT_texture_compression_s3tc);
+
     /* upload data */
-    GLuint id = 0;
-    glGenTextures(1, &id);
-    glBindTexture(GL_TEXTURE_2D, id);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    Texture texture;
+    texture.width = image.levels.front().width;
+    texture.height = image.levels.front().height;
+    texture.levels = image.levels.size();
+    texture.format = image.format;
+
+    glGenTextures(1, &texture.id);
+    glBindTexture(GL_TEXTURE_2D, texture.id);
+    for(unsigned int i = 0; i < texture.levels; i++)
+    {
+        textureUploadLevel(image, i, image.levels[i].data.data());
+        texture.size += image.levels[i].data.size();
+    }
     glCheckError();
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture.levels - 1);
+    textureSetAnisotropy();
     glCheckError();
 
-    stbi_image_free(data);
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    return Texture{id, (unsigned int) width, (unsigned int) height};
+    return texture;
 }
 
 void textureDelete(const Texture &texture)
@@ -2,22 +2,87 @@
 
 #include "base.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 struct Texture
 {
     GLuint id = 0;
 
     unsigned int width = 0;
     unsigned int height = 0;
+
+    /* number of mip levels and the internal format they are stored in (GL_RGBA8 or one of the S3TC formats) */
+    unsigned int levels = 0;
+    GLenum format = 0;
+
+    /* bytes of all levels on the GPU */
+    std::size_t size = 0;
+};
+
+/* mip level in system memory, tightly packed RGBA8 or 4x4 blocks */
+struct TextureLevel
+{
+    unsigned int width = 0;
+    unsigned int height = 0;
+    std::vector<std::uint8_t> data;
 };
 
+/* decoded texture with its full mip chain, level 0 is the finest */
+struct TextureImage
+{
+    GLenum format = GL_RGBA8;
+    std::vector<TextureLevel> levels;
+};
+
+/**
+ * @brief Decodes an image file and builds its mip chain, or reads it from the path.vctex cache. Does not touch OpenGL
+ * and can run on any thread.
+ *
+ * @param path Path to texture file.
+ * @param compress Block compress the levels, only pass true if the driver supports S3TC.
+ *
+ * @return Mip chain of the image.
+ */
+TextureImage textureImageLoad(const std::string& path, bool compress);
+
+/**
+ * @brief Defines one mip level of the bound GL_TEXTURE_2D in the format of the image.
+ *
+ * @param image Image the level belongs to.
+ * @param level Mip level.
+ * @param data Pixel data of the level or, with a pixel unpack buffer bound, the offset into it.
+ */
+void textureUploadLevel(const TextureImage& image, unsigned int level, const void* data);
+
+/**
+ * @brief Whether a texture format is one of the block compressed formats textureLoad produces.
+ *
+ * @param format Internal format.
+ *
+ * @return True for BC1 and BC3.
+ */
+bool textureCompressed(GLenum format);
+
+/**
+ * @brief Enables anisotropic filtering on the bound texture, up to 16x if the driver supports it.
+ *
+ * @param target Texture target, GL_TEXTURE_2D or GL_TEXTURE_2D_ARRAY.
+ */
+void textureSetAnisotropy(GLenum target = GL_TEXTURE_2D);
+
 /**
- * @brief Initialize OpenGL texture and load it from file.
+ * @brief Initialize OpenGL texture and load it from file. A full mip chain is generated and, if the driver supports
+ * S3TC, block compressed (BC1 for opaque images, BC3 otherwise). The result is cached next to the file as
+ * path.vctex and loaded from there as long as the image did not change.
  *
  * @param path Path to texture file.
+ * @param compress Block compress the texture if supported, false keeps it as RGBA8.
  *
  * @return Initialized texture object.
  */
-Texture textureLoad(const std::string& path);
+Texture textureLoad(const std::string& path, bool compress = true);
 /**
  * @brief Delete texture object. Has to be called for each texture after it is not used anymore.
  *
@@ -0,0 +1,79 @@
+#include "texturearray.h"
+#include "cpuprofiler.h"
+
+#include <stdexcept>
+#include <iostream>
+
+TextureArray textureArrayCreate(const std::vector<const TextureImage*>& images)
+{
+    PROFILE_ZONE("textureArrayCreate");
+
+    if(images.empty())
+    {
+        throw std::runtime_error("[TextureArray] no layers given");
+    }
+
+    const TextureImage& first = *images.front();
+    for(const TextureImage* image : images)
+    {
+        if(image->format != first.format || image->levels.size() != first.levels.size() ||
+           image->levels.front().width != first.levels.front().width || image->levels.front().height != first.levels.front().height)
+        {
+            std::cerr << "[TextureArray] layers differ in size or format" << std::endl;
+            throw std::runtime_error("[TextureArray] layers differ in size or format");
+        }
+    }
+
+    TextureArray array;
+    array.width = first.levels.front().width;
+    array.height = first.levels.front().height;
+    array.levels = first.levels.size();
+    array.layers = images.size();
+    array.format = first.format;
+
+    glGenTextures(1, &array.id);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, array.id);
+    for(unsigned int level = 0; level < array.levels; level++)
+    {
+        const auto& l = first.levels[level];
+
+        /* allocate all layers of the level, then fill them one by one */
+        if(textureCompressed(array.format))
+        {
+            glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, array.format, l.width, l.height, array.layers, 0, l.data.size() * array.layers, nullptr);
+            for(unsigned int layer = 0; layer < array.layers; layer++)
+            {
+                const auto& data = images[layer]->levels[level].data;
+                glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, l.width, l.height, 1, array.format, data.size(), data.data());
+            }
+        }
+        else
+        {
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, l.width, l.height, array.layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            for(unsigned int layer = 0; layer < array.layers; layer++)
+            {
+                const auto& data = images[layer]->levels[level].data;
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, l.width, l.height, 1, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+            }
+        }
+        array.size += l.data.size() * array.layers;
+    }
+    glCheckError();
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, array.levels - 1);
+    textureSetAnisotropy(GL_TEXTURE_2D_ARRAY);
+    glCheckError();
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    return array;
+}
+
+void textureArrayDelete(const TextureArray& array)
+{
+    glDeleteTextures(1, &array.id);
+}
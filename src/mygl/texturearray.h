@@ -0,0 +1,38 @@
+#pragma once
+
+#include "texture.h"
+
+#include <cstddef>
+#include <vector>
+
+/* textures of the same size, format and mip count stored as layers of one GL_TEXTURE_2D_ARRAY */
+struct TextureArray
+{
+    GLuint id = 0;
+
+    unsigned int width = 0;
+    unsigned int height = 0;
+    unsigned int levels = 0;
+    unsigned int layers = 0;
+    GLenum format = 0;
+
+    /* bytes of all layers and levels on the GPU */
+    std::size_t size = 0;
+};
+
+/**
+ * @brief Creates a texture array with one layer per image, in the order of the images. Uses the same sampling
+ * parameters as textureLoad.
+ *
+ * @param images Mip chains of equal size, format and level count.
+ *
+ * @return Initialized texture array.
+ */
+TextureArray textureArrayCreate(const std::vector<const TextureImage*>& images);
+
+/**
+ * @brief Delete texture array. Has to be called for each texture array after it is not used anymore.
+ *
+ * @param array Texture array to delete.
+ */
+void textureArrayDelete(const TextureArray& array);
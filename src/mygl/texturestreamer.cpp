@@ -0,0 +1,441 @@
+#include "texturestreamer.h"
+
+#include "cpuprofiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+struct TextureStreamerJob
+{
+    unsigned int handle = 0;
+    std::string path;
+    float priority = 0.0f;
+};
+
+struct TextureStreamerResult
+{
+    unsigned int handle = 0;
+    TextureImage image;
+    std::string error;
+};
+
+struct TextureStreamerWorker
+{
+    bool compress = true;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<TextureStreamerJob> jobs;
+    std::vector<TextureStreamerResult> results;
+    bool stop = false;
+
+    std::vector<std::thread> threads;
+};
+
+namespace detail
+{
+
+void textureStreamerDecode(TextureStreamerWorker& worker)
+{
+    PROFILE_THREAD("textureDecode");
+
+    while(true)
+    {
+        TextureStreamerJob job;
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.wake.wait(lock, [&] { return worker.stop || !worker.jobs.empty(); });
+            if(worker.stop)
+            {
+                return;
+            }
+
+            /* most important texture first, priorities are refreshed by every update */
+            auto next = std::max_element(worker.jobs.begin(), worker.jobs.end(),
+                                         [](const auto& a, const auto& b) { return a.priority < b.priority; });
+            job = std::move(*next);
+            worker.jobs.erase(next);
+        }
+
+        TextureStreamerResult result;
+        result.handle = job.handle;
+        try
+        {
+            result.image = textureImageLoad(job.path, worker.compress);
+        }
+        catch(const std::exception& e)
+        {
+            result.error = e.what();
+        }
+
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.results.push_back(std::move(result));
+    }
+}
+
+/* frees the finest resident level, the coarsest one always stays so the placeholder never comes back */
+void textureStreamerEvict(TextureStreamer& streamer, TextureStreamer::Entry& entry)
+{
+    unsigned int level = entry.residentLevel;
+    std::size_t size = entry.image.levels[level].data.size();
+
+    glBindTexture(GL_TEXTURE_2D, entry.id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level + 1);
+    /* redefining the level as empty releases its storage, the texture stays complete from the base level on */
+    glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    entry.residentLevel++;
+    entry.residentSize -= size;
+    streamer.residentSize -= size;
+    streamer.evictedLevels++;
+}
+
+/* bytes textureStreamerMakeRoom could free from the entries in order[first, end), everything but their coarsest level */
+std::size_t textureStreamerEvictable(const TextureStreamer& streamer, const std::vector<unsigned int>& order, std::size_t first)
+{
+    std::size_t evictable = 0;
+    for(std::size_t i = first; i < order.size(); i++)
+    {
+        const auto& entry = streamer.entries[order[i]];
+        for(unsigned int level = entry.residentLevel; level + 1 < entry.image.levels.size(); level++)
+        {
+            evictable += entry.image.levels[level].data.size();
+        }
+    }
+    return evictable;
+}
+
+/* evicts levels of the entries in order[first, end) (least important last) until needed more bytes fit into the budget.
+ * Levels finer than wanted go first, then levels that are wanted but less important */
+bool textureStreamerMakeRoom(TextureStreamer& streamer, const std::vector<unsigned int>& order, std::size_t first, std::size_t needed)
+{
+    for(int pass = 0; pass < 2; pass++)
+    {
+        for(std::size_t i = order.size(); i-- > first && streamer.residentSize + needed > streamer.budget;)
+        {
+            auto& entry = streamer.entries[order[i]];
+            unsigned int limit = pass == 0 ? entry.wantedLevel : entry.image.levels.size() - 1;
+            while(entry.residentLevel < limit && streamer.residentSize + needed > streamer.budget)
+            {
+                textureStreamerEvict(streamer, entry);
+            }
+        }
+    }
+    return streamer.residentSize + needed <= streamer.budget;
+}
+
+/* copies the level into the next free pixel buffer and defines it from there, false if all buffers are in flight */
+bool textureStreamerUpload(TextureStreamer& streamer, TextureStreamer::Entry& entry, unsigned int level)
+{
+    auto& upload = streamer.uploads[streamer.nextUpload % TextureStreamer::UPLOAD_COUNT];
+    if(upload.fence)
+    {
+        GLenum status = glClientWaitSync(upload.fence, 0, 0);
+        if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        {
+            return false;
+        }
+        glDeleteSync(upload.fence);
+        upload.fence = nullptr;
+    }
+
+    const auto& data = entry.image.levels[level].data;
+
+    /* orphan the previous storage, the driver hands out fresh memory instead of synchronizing */
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload.pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, data.size(), nullptr, GL_STREAM_DRAW);
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, data.size(), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if(!mapped)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        std::cerr << "[TextureStreamer] couldn't map pixel buffer for " << entry.path << std::endl;
+        return false;
+    }
+    std::memcpy(mapped, data.data(), data.size());
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    glBindTexture(GL_TEXTURE_2D, entry.id);
+    textureUploadLevel(entry.image, level, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+
+    /* first real level, switch from the placeholder to the mip chain */
+    if(entry.residentLevel == entry.image.levels.size())
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, entry.image.levels.size() - 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        textureSetAnisotropy();
+    }
+
+    upload.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glCheckError();
+
+    entry.residentLevel = level;
+    entry.residentSize += data.size();
+    streamer.residentSize += data.size();
+    streamer.uploadedLevels++;
+    streamer.nextUpload++;
+
+    return true;
+}
+
+}
+
+TextureStreamer textureStreamerCreate(std::size_t budget, std::size_t uploadBudget, unsigned int threads, bool compress)
+{
+    TextureStreamer streamer;
+    streamer.budget = budget;
+    streamer.uploadBudget = uploadBudget;
+    streamer.compress = compress && GLAD_GL_EXT_texture_compression_s3tc;
+
+    for(auto& upload : streamer.uploads)
+    {
+        glGenBuffers(1, &upload.pbo);
+    }
+    glCheckError();
+
+    /* leave two hardware threads for rendering and simulation */
+    if(threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency() - std::min(2u, std::thread::hardware_concurrency()));
+    }
+
+    streamer.worker = new TextureStreamerWorker();
+    streamer.worker->compress = streamer.compress;
+    for(unsigned int i = 0; i < threads; i++)
+    {
+        streamer.worker->threads.emplace_back(detail::textureStreamerDecode, std::ref(*streamer.worker));
+    }
+
+    return streamer;
+}
+
+unsigned int textureStreamerAdd(TextureStreamer& streamer, const std::string& path)
+{
+    unsigned int handle = streamer.entries.size();
+    auto& entry = streamer.entries.emplace_back();
+    entry.path = path;
+
+    /* neutral gray until the first level arrived */
+    const unsigned char placeholder[4] = {128, 128, 128, 255};
+    glGenTextures(1, &entry.id);
+    glBindTexture(GL_TEXTURE_2D, entry.id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glCheckError();
+
+    {
+        std::lock_guard<std::mutex> lock(streamer.worker->mutex);
+        streamer.worker->jobs.push_back({handle, path, 0.0f});
+    }
+    streamer.worker->wake.notify_one();
+
+    return handle;
+}
+
+void textureStreamerRemove(TextureStreamer& streamer, unsigned int handle)
+{
+    auto& entry = streamer.entries[handle];
+
+    {
+        std::lock_guard<std::mutex> lock(streamer.worker->mutex);
+        auto& jobs = streamer.worker->jobs;
+        jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [&](const auto& job) { return job.handle == handle; }), jobs.end());
+    }
+
+    glDeleteTextures(1, &entry.id);
+    streamer.residentSize -= entry.residentSize;
+
+    /* a decode that is already running finishes, its result is dropped by the next update */
+    entry = TextureStreamer::Entry();
+    entry.removed = true;
+}
+
+void textureStreamerRequest(TextureStreamer& streamer, unsigned int handle, float screenSize)
+{
+    auto& entry = streamer.entries[handle];
+    entry.screenSize = std::max(entry.screenSize, screenSize);
+}
+
+float textureStreamerScreenSize(const Camera& cam, const Vector3D& center, float radius)
+{
+    float distance = length(center - cam.position);
+    if(distance <= radius)
+    {
+        return std::max(cam.width, cam.height);
+    }
+    return radius / (distance * std::tan(0.5f * cam.fov)) * cam.height;
+}
+
+void textureStreamerUpdate(TextureStreamer& streamer)
+{
+    PROFILE_ZONE("textureStreamerUpdate");
+
+    /* take over finished decodes and pass the current priorities to the pending ones */
+    std::vector<TextureStreamerResult> results;
+    {
+        std::lock_guard<std::mutex> lock(streamer.worker->mutex);
+        results.swap(streamer.worker->results);
+        for(auto& job : streamer.worker->jobs)
+        {
+            job.priority = streamer.entries[job.handle].screenSize;
+        }
+    }
+
+    for(auto& result : results)
+    {
+        auto& entry = streamer.entries[result.handle];
+        if(entry.removed)
+        {
+            continue;
+        }
+        if(!result.error.empty())
+        {
+            std::cerr << "[TextureStreamer] " << result.error << std::endl;
+            entry.failed = true;
+            continue;
+        }
+        entry.image = std::move(result.image);
+        entry.loaded = true;
+        entry.residentLevel = entry.image.levels.size();
+        entry.wantedLevel = entry.image.levels.size() - 1;
+    }
+
+    /* the level whose texels are about as large as a pixel, textures that were not requested keep what they wanted */
+    std::vector<unsigned int> order;
+    for(unsigned int i = 0; i < streamer.entries.size(); i++)
+    {
+        auto& entry = streamer.entries[i];
+        if(!entry.loaded)
+        {
+            continue;
+        }
+
+        if(entry.screenSize > 0.0f)
+        {
+            const auto& base = entry.image.levels.front();
+            float texels = std::max(base.width, base.height);
+            int level = std::floor(std::log2(std::max(texels / entry.screenSize, 1.0f)));
+            entry.wantedLevel = std::min<unsigned int>(level, entry.image.levels.size() - 1);
+        }
+        order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+        return streamer.entries[a].screenSize > streamer.entries[b].screenSize;
+    });
+
+    /* the budget may have been lowered */
+    detail::textureStreamerMakeRoom(streamer, order, 0, 0);
+
+    std::size_t uploaded = 0;
+    bool stalled = false;
+    for(std::size_t i = 0; i < order.size() && !stalled; i++)
+    {
+        auto& entry = streamer.entries[order[i]];
+        while(entry.residentLevel > entry.wantedLevel)
+        {
+            unsigned int level = entry.residentLevel - 1;
+            std::size_t size = entry.image.levels[level].data.size();
+            bool first = entry.residentLevel == entry.image.levels.size();
+
+            /* the coarsest level replaces the placeholder and is always allowed, finer ones have to fit. Nothing is
+             * evicted for a level that would not fit anyway, the less important textures would upload it again */
+            if(!first && (uploaded + size > streamer.uploadBudget ||
+                          streamer.residentSize + size > streamer.budget + detail::textureStreamerEvictable(streamer, order, i + 1)))
+            {
+                stalled = uploaded + size > streamer.uploadBudget;
+                break;
+            }
+            if(!first)
+            {
+                detail::textureStreamerMakeRoom(streamer, order, i + 1, size);
+            }
+            if(!detail::textureStreamerUpload(streamer, entry, level))
+            {
+                stalled = true;
+                break;
+            }
+            uploaded += size;
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    for(auto& entry : streamer.entries)
+    {
+        entry.screenSize = 0.0f;
+    }
+}
+
+GLuint textureStreamerTexture(const TextureStreamer& streamer, unsigned int handle)
+{
+    return streamer.entries[handle].id;
+}
+
+void textureStreamerReport(const TextureStreamer& streamer)
+{
+    unsigned int loaded = 0, failed = 0, removed = 0;
+    for(const auto& entry : streamer.entries)
+    {
+        loaded += entry.loaded;
+        failed += entry.failed;
+        removed += entry.removed;
+    }
+
+    std::cout << "[TextureStreamer] " << loaded << "/" << streamer.entries.size() - removed << " textures decoded";
+    if(failed > 0)
+    {
+        std::cout << " (" << failed << " failed)";
+    }
+    std::cout << ", resident " << streamer.residentSize / 1024 << " of " << streamer.budget / 1024 << " KiB, "
+              << streamer.uploadedLevels << " levels uploaded, " << streamer.evictedLevels << " evicted" << std::endl;
+}
+
+void textureStreamerDelete(TextureStreamer& streamer)
+{
+    if(streamer.worker)
+    {
+        {
+            std::lock_guard<std::mutex> lock(streamer.worker->mutex);
+            streamer.worker->stop = true;
+        }
+        streamer.worker->wake.notify_all();
+        for(auto& thread : streamer.worker->threads)
+        {
+            thread.join();
+        }
+
+        delete streamer.worker;
+        streamer.worker = nullptr;
+    }
+
+    for(auto& upload : streamer.uploads)
+    {
+        if(upload.fence)
+        {
+            glDeleteSync(upload.fence);
+            upload.fence = nullptr;
+        }
+        glDeleteBuffers(1, &upload.pbo);
+    }
+
+    for(auto& entry : streamer.entries)
+    {
+        if(!entry.removed)
+        {
+            glDeleteTextures(1, &entry.id);
+        }
+    }
+    streamer.entries.clear();
+    streamer.residentSize = 0;
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "camera.h"
+#include "texture.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/* decoder threads and their job queue, only known to texturestreamer.cpp */
+struct TextureStreamerWorker;
+
+struct TextureStreamer
+{
+    /* pixel unpack buffers in flight, a buffer is reused once the GPU consumed its upload */
+    static constexpr unsigned int UPLOAD_COUNT = 8;
+
+    struct Upload
+    {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+    };
+
+    struct Entry
+    {
+        std::string path;
+
+        /* stays the same while levels are streamed in and out */
+        GLuint id = 0;
+
+        /* decoded mip chain in system memory, evicted levels are uploaded again from here */
+        TextureImage image;
+        bool loaded = false;
+        bool failed = false;
+        bool removed = false;
+
+        /* finest level on the GPU, image.levels.size() while only the placeholder is bound */
+        unsigned int residentLevel = 0;
+        unsigned int wantedLevel = 0;
+        std::size_t residentSize = 0;
+
+        /* largest projected size in pixels requested since the last update, the priority of the texture */
+        float screenSize = 0.0f;
+    };
+
+    std::vector<Entry> entries;
+    bool compress = true;
+
+    /* bytes of mip levels that may be resident and bytes uploaded per update */
+    std::size_t budget = 0;
+    std::size_t uploadBudget = 0;
+    std::size_t residentSize = 0;
+
+    Upload uploads[UPLOAD_COUNT];
+    unsigned int nextUpload = 0;
+
+    /* statistics for the report */
+    unsigned int uploadedLevels = 0;
+    unsigned int evictedLevels = 0;
+
+    TextureStreamerWorker* worker = nullptr;
+};
+
+/**
+ * @brief Starts the decoder threads and creates the pixel buffers used for uploads.
+ *
+ * @param budget Maximum bytes of resident mip levels, the finest levels of the least important textures are evicted
+ * to stay below.
+ * @param uploadBudget Bytes uploaded per textureStreamerUpdate, the first level of a texture is always uploaded.
+ * @param threads Number of decoder threads, 0 picks one per spare hardware thread.
+ * @param compress Block compress textures if the driver supports S3TC.
+ *
+ * @return Running texture streamer.
+ */
+TextureStreamer textureStreamerCreate(std::size_t budget, std::size_t uploadBudget = std::size_t(4) << 20,
+                                      unsigned int threads = 0, bool compress = true);
+
+/**
+ * @brief Adds a texture to the streamer. A 1x1 gray placeholder is bound until its first mip level arrived, the file
+ * is decoded in the background.
+ *
+ * @param streamer Texture streamer.
+ * @param path Path to texture file.
+ *
+ * @return Handle of the texture.
+ */
+unsigned int textureStreamerAdd(TextureStreamer& streamer, const std::string& path);
+
+/**
+ * @brief Removes a texture from the streamer and deletes it, a pending decode is dropped. The handle is not reused.
+ *
+ * @param streamer Texture streamer.
+ * @param handle Handle returned by textureStreamerAdd.
+ */
+void textureStreamerRemove(TextureStreamer& streamer, unsigned int handle);
+
+/**
+ * @brief Requests a texture for this frame. The largest size requested between two updates decides which mip level is
+ * needed and in which order textures are decoded, uploaded and evicted.
+ *
+ * @param streamer Texture streamer.
+ * @param handle Handle returned by textureStreamerAdd.
+ * @param screenSize Size of the texture on screen in pixels (see textureStreamerScreenSize).
+ */
+void textureStreamerRequest(TextureStreamer& streamer, unsigned int handle, float screenSize);
+
+/**
+ * @brief Estimates the size in pixels a bounding sphere covers on screen.
+ *
+ * @param cam Camera the scene is drawn with.
+ * @param center Center of the sphere in world space.
+ * @param radius Radius of the sphere.
+ *
+ * @return Projected diameter in pixels.
+ */
+float textureStreamerScreenSize(const Camera& cam, const Vector3D& center, float radius);
+
+/**
+ * @brief Streams textures, has to be called once per frame on the GL thread. Takes over finished decodes, evicts levels
+ * to stay below the budget and uploads missing levels from coarsest to finest, most important texture first. Never
+ * waits for the GPU or the decoders.
+ *
+ * @param streamer Texture streamer.
+ */
+void textureStreamerUpdate(TextureStreamer& streamer);
+
+/**
+ * @brief Get the OpenGL texture of a handle, valid from textureStreamerAdd on.
+ *
+ * @param streamer Texture streamer.
+ * @param handle Handle returned by textureStreamerAdd.
+ *
+ * @return OpenGL texture id.
+ */
+GLuint textureStreamerTexture(const TextureStreamer& streamer, unsigned int handle);
+
+/**
+ * @brief Prints resident memory, pending decodes and the number of uploaded and evicted levels.
+ *
+ * @param streamer Texture streamer.
+ */
+void textureStreamerReport(const TextureStreamer& streamer);
+
+/**
+ * @brief Stops the decoder threads and deletes all textures and pixel buffers.
+ *
+ * @param streamer Texture streamer to delete.
+ */
+void textureStreamerDelete(TextureStreamer& streamer);
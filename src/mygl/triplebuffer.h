@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+
+/**
+ * Lock-free hand over of the latest value from one writer to one reader thread. The writer fills its back slot and
+ * swaps it with the middle slot, the reader swaps its front slot with the middle slot if that holds a newer value. Each
+ * side always owns one slot exclusively, so the writer never waits for the reader and the reader never sees a slot that
+ * is still being written.
+ */
+template<typename T>
+struct TripleBuffer
+{
+    static constexpr unsigned int FRESH = 4;
+
+    T slots[3] = {};
+
+    /* index of the middle slot, FRESH is set if the writer published it after the reader last took it */
+    std::atomic<unsigned int> middle{1};
+
+    /* owned by the writer and the reader respectively */
+    unsigned int back = 0;
+    unsigned int front = 2;
+};
+
+/**
+ * @brief Returns the slot the writer fills next. Must only be called from the writer thread.
+ *
+ * @param buffer Triple buffer.
+ *
+ * @return Slot that is not visible to the reader until tripleBufferPublish is called.
+ */
+template<typename T>
+T& tripleBufferBack(TripleBuffer<T>& buffer)
+{
+    return buffer.slots[buffer.back];
+}
+
+/**
+ * @brief Makes the back slot the newest value. Must only be called from the writer thread.
+ *
+ * @param buffer Triple buffer.
+ */
+template<typename T>
+void tripleBufferPublish(TripleBuffer<T>& buffer)
+{
+    unsigned int previous = buffer.middle.exchange(buffer.back | TripleBuffer<T>::FRESH, std::memory_order_acq_rel);
+    buffer.back = previous & ~TripleBuffer<T>::FRESH;
+}
+
+/**
+ * @brief Takes the newest published value if there is one. Must only be called from the reader thread.
+ *
+ * @param buffer Triple buffer.
+ *
+ * @return True if the front slot changed since the last call.
+ */
+template<typename T>
+bool tripleBufferAcquire(TripleBuffer<T>& buffer)
+{
+    if(!(buffer.middle.load(std::memory_order_relaxed) & TripleBuffer<T>::FRESH))
+    {
+        return false;
+    }
+
+    unsigned int previous = buffer.middle.exchange(buffer.front, std::memory_order_acq_rel);
+    buffer.front = previous & ~TripleBuffer<T>::FRESH;
+    return true;
+}
+
+/**
+ * @brief Returns the slot taken by the last tripleBufferAcquire. Must only be called from the reader thread.
+ *
+ * @param buffer Triple buffer.
+ *
+ * @return Newest value the reader has taken.
+ */
+template<typename T>
+const T& tripleBufferFront(const TripleBuffer<T>& buffer)
+{
+    return buffer.slots[buffer.front];
+}
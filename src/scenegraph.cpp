@@ -0,0 +1,62 @@
+#include "scenegraph.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+unsigned int sceneGraphAdd(SceneGraph& graph, unsigned int parent, const Affine3D& local)
+{
+    unsigned int node = graph.parents.size();
+    if(parent != SceneGraph::NO_PARENT && parent >= node)
+    {
+        std::cerr << "[SceneGraph] parent " << parent << " of node " << node << " does not exist" << std::endl;
+        throw std::runtime_error("[SceneGraph] parent has to be added before its children");
+    }
+
+    graph.parents.push_back(parent);
+    graph.locals.push_back(local);
+    graph.worlds.push_back(local);
+    graph.dirty.push_back(1);
+    graph.firstDirty = std::min(graph.firstDirty, node);
+
+    return node;
+}
+
+void sceneGraphSetLocal(SceneGraph& graph, unsigned int node, const Affine3D& local)
+{
+    graph.locals[node] = local;
+    graph.dirty[node] = 1;
+    graph.firstDirty = std::min(graph.firstDirty, node);
+}
+
+void sceneGraphUpdate(SceneGraph& graph)
+{
+    unsigned int count = graph.parents.size();
+    graph.updatedNodes = 0;
+
+    /* nodes before the first dirty one and their parents are clean, a child is dirty if its parent was updated */
+    for(unsigned int node = graph.firstDirty; node < count; node++)
+    {
+        unsigned int parent = graph.parents[node];
+        bool parentDirty = parent != SceneGraph::NO_PARENT && parent >= graph.firstDirty && graph.dirty[parent];
+        if(!graph.dirty[node] && !parentDirty)
+        {
+            continue;
+        }
+
+        graph.dirty[node] = 1;
+        graph.worlds[node] = parent == SceneGraph::NO_PARENT ? graph.locals[node] : graph.worlds[parent] * graph.locals[node];
+        graph.updatedNodes++;
+    }
+
+    if(graph.firstDirty < count)
+    {
+        std::fill(graph.dirty.begin() + graph.firstDirty, graph.dirty.end(), 0);
+    }
+    graph.firstDirty = count;
+}
+
+const Affine3D& sceneGraphWorld(const SceneGraph& graph, unsigned int node)
+{
+    return graph.worlds[node];
+}
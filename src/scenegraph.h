@@ -0,0 +1,65 @@
+#pragma once
+
+#include "mygl/base.h"
+
+#include <cstdint>
+#include <vector>
+
+/* transform hierarchy in flat arrays. A parent is always added before its children, so the arrays are in topological
+ * order and one pass from the front updates all world transformations */
+struct SceneGraph
+{
+    static constexpr unsigned int NO_PARENT = ~0u;
+
+    std::vector<unsigned int> parents;
+    std::vector<Affine3D> locals;
+
+    /* world transformation of every node, contiguous 3 vec4 rows each so they can be uploaded as they are */
+    std::vector<Affine3D> worlds;
+
+    /* nodes whose local transformation changed since the last update, their subtrees are recomputed */
+    std::vector<std::uint8_t> dirty;
+    unsigned int firstDirty = 0;
+
+    /* nodes recomputed by the last update */
+    unsigned int updatedNodes = 0;
+};
+
+/**
+ * @brief Adds a node to the scene graph.
+ *
+ * @param graph Scene graph.
+ * @param parent Index of the parent node or SceneGraph::NO_PARENT for a root.
+ * @param local Transformation relative to the parent.
+ *
+ * @return Index of the node.
+ */
+unsigned int sceneGraphAdd(SceneGraph& graph, unsigned int parent, const Affine3D& local = Affine3D::identity());
+
+/**
+ * @brief Sets the local transformation of a node and marks it dirty, the world transformations of the node and its
+ * subtree are recomputed by the next sceneGraphUpdate.
+ *
+ * @param graph Scene graph.
+ * @param node Index of the node.
+ * @param local Transformation relative to the parent.
+ */
+void sceneGraphSetLocal(SceneGraph& graph, unsigned int node, const Affine3D& local);
+
+/**
+ * @brief Recomputes the world transformations of all dirty nodes and their descendants in one pass in topological
+ * order, clean subtrees are skipped.
+ *
+ * @param graph Scene graph.
+ */
+void sceneGraphUpdate(SceneGraph& graph);
+
+/**
+ * @brief Get the world transformation of a node as of the last sceneGraphUpdate.
+ *
+ * @param graph Scene graph.
+ * @param node Index of the node.
+ *
+ * @return World transformation.
+ */
+const Affine3D& sceneGraphWorld(const SceneGraph& graph, unsigned int node);
@@ -13,6 +13,15 @@ layout(binding = 3) uniform sampler2D texDepth;
 uniform mat4 uProj;
 uniform mat4 uInvProj;
 
+uniform float uMaxDistance;
+uniform int   uSteps;
+uniform float uThickness;
+
+/* With temporal accumulation only every uStride-th step of the first pass is tested, starting at a per pixel and
+ * per frame offset (uJitter), so consecutive frames test different positions along the ray */
+uniform int   uStride;
+uniform float uJitter;
+
 /* Neat linearization that may or may not work, sourced from github.com/pissang */
 float linearDepth(float depth)
 {
@@ -24,11 +33,17 @@ float linearize(float depth){
     return (2.0*0.01*200.0) / (0.01 + 200.0 - (depth * 2.0 - 1.0) * (200.0 - 0.01));
 }
 
+/* Interleaved gradient noise (Jimenez 2014), cheap per pixel offset for the stride */
+float noise(vec2 fragCoord)
+{
+    return fract(52.9829189 * fract(dot(fragCoord, vec2(0.06711056, 0.00583715))));
+}
+
 void main(void)
 {   
-    float maxDistance = 15;
-    int   steps       = 10;
-    float thickness   = 0.5;
+    float maxDistance = uMaxDistance;
+    int   steps       = uSteps;
+    float thickness   = uThickness;
 
     vec2 texSize  = textureSize(texPos, 0).xy;
 
@@ -48,12 +63,11 @@ void main(void)
 
     // Using the depth buffer results in no reflections for some reason (probably reading it wrong)
 
-    vec3 Color = ColorSpec.rgb;
     // Wouldn't want the sky to be reflective (because w=1) (just don't set the specularity of objects to 1.0)
     float Spec = ColorSpec.w == 1.0f? 0.0 : ColorSpec.w;
 
-    // If no hit is found, do not add any color
-    FragColor = vec4(Color, 1.0f);
+    // If no hit is found, do not add any color (only the reflection is written here, SSRComposite.frag adds it onto the scene)
+    FragColor = vec4(0.0f);
 
     if(Spec > 0.2f){
       bool Pass1Hit = false;
@@ -101,7 +115,16 @@ void main(void)
       int sx = startFrag.x<endFrag.x ? 1 : -1, sy = startFrag.y<endFrag.y ? 1 : -1;
 
       /* The problem isn't in the 2/3 Bresenham (I've checked) */
-      for(Progress = 0; Progress < maxDistance; Progress++){
+      int Offset = int(fract(noise(gl_FragCoord.xy) + uJitter) * uStride);
+      for(Progress = 0; Progress < Offset; Progress++){
+        if (currentFragment.x==endFrag.x && currentFragment.y==endFrag.y) break;
+
+        e2 = err;
+        if (e2 >-dx) { err -= dy; currentFragment.x += sx; }
+        if (e2 < dy) { err += dx; currentFragment.y += sy; }
+      }
+
+      for(; Progress < maxDistance; Progress += uStride){
         
         uv.xy = currentFragment.xy / texSize;
         depth = linearize(texture(texPos, uv.xy).z);
@@ -119,16 +142,21 @@ void main(void)
         // We've arrived at the end of the ray
         if (currentFragment.x==endFrag.x && currentFragment.y==endFrag.y) break;
 
-        e2 = err;
-        if (e2 >-dx) { err -= dy; currentFragment.x += sx; }
-        if (e2 < dy) { err += dx; currentFragment.y += sy; }
+        // Walk the line for the whole stride, only the last position gets tested
+        for(int s = 0; s < uStride; s++){
+          if (currentFragment.x==endFrag.x && currentFragment.y==endFrag.y) break;
+
+          e2 = err;
+          if (e2 >-dx) { err -= dy; currentFragment.x += sx; }
+          if (e2 < dy) { err += dx; currentFragment.y += sy; }
+        }
       }
 
       /* Second pass */
       if(Pass1Hit){
         // Look for a hit between the last position where there was no hit and the position where there was one
         // Maybe we should center this on the hit point instead?  [1/2] Hitpoint [1/2]
-        vec3 startPos = startView.xyz + (Progress - 1) * Reflected;
+        vec3 startPos = startView.xyz + (Progress - uStride) * Reflected;
         vec3 endPos = startView.xyz + Progress * Reflected;
 
         vec3 currentPos = startPos;
@@ -144,9 +172,9 @@ void main(void)
           if(dDepth > 0 && dDepth < thickness){
             Pass2Hit = true;
             uv.xy = currentPos.xy;
-            currentPos -= Reflected * 1/pow(2, i+1);
+            currentPos -= Reflected * uStride/pow(2, i+1);
           } else{
-            currentPos += Reflected * 1/pow(2, i+1);
+            currentPos += Reflected * uStride/pow(2, i+1);
           }
         }
 
@@ -164,7 +192,7 @@ void main(void)
          * The background color
          */
         if(Pass2Hit){
-          FragColor += clamp(texture(texColSpec, uv.xy), 0, 1);
+          FragColor = vec4(clamp(texture(texColSpec, uv.xy).rgb, 0, 1), 1.0f);
         }
       }
     }
@@ -0,0 +1,81 @@
+#version 420 core
+
+in vec2 tUV;
+
+out vec4 FragColor;
+
+layout(binding = 0) uniform sampler2D texPos;
+layout(binding = 1) uniform sampler2D texNorm;
+layout(binding = 2) uniform sampler2D texColSpec;
+layout(binding = 4) uniform sampler2D texReflection;
+layout(binding = 5) uniform sampler2D texTracePos;
+layout(binding = 6) uniform sampler2D texTraceNorm;
+
+uniform mat4 uView;
+uniform int  uScale;
+
+float viewDepth(vec3 position)
+{
+    return -(uView * vec4(position, 1.0)).z;
+}
+
+/* Joint bilateral upsampling: the four trace texels around this pixel are blended bilinearly, but each one is
+ * weighted down if its depth or normal disagree with the full resolution gBuffer, so reflections do not bleed over edges */
+vec3 upsample(ivec2 coord)
+{
+    vec3  Position = texelFetch(texPos, coord, 0).xyz;
+    vec3  Normal   = normalize(texelFetch(texNorm, coord, 0).xyz);
+    float depth    = viewDepth(Position);
+
+    ivec2 traceSize = textureSize(texReflection, 0);
+    vec2  traceCoord = gl_FragCoord.xy / float(uScale) - 0.5;
+    ivec2 base = ivec2(floor(traceCoord));
+    vec2  f = fract(traceCoord);
+
+    vec3  sum = vec3(0.0);
+    float weightSum = 0.0;
+
+    // Used if every neighbour got rejected (e.g. single pixel features that were dropped while downsampling)
+    vec3  fallback = vec3(0.0);
+    float fallbackWeight = 0.0;
+
+    for(int i = 0; i < 4; i++){
+      ivec2 offset = ivec2(i & 1, i >> 1);
+      ivec2 texel  = clamp(base + offset, ivec2(0), traceSize - 1);
+
+      vec4 tracePos  = texelFetch(texTracePos, texel, 0);
+      vec3 traceNorm = texelFetch(texTraceNorm, texel, 0).xyz;
+
+      float bilinear = (offset.x == 1 ? f.x : 1.0 - f.x) * (offset.y == 1 ? f.y : 1.0 - f.y);
+      float wDepth   = 1.0 / (1e-3 + 32.0 * abs(viewDepth(tracePos.xyz) - depth) / max(depth, 1e-3));
+      float wNormal  = pow(max(dot(traceNorm, Normal), 0.0), 16.0);
+      float weight   = wDepth * wNormal * tracePos.w;
+
+      vec3 reflection = texelFetch(texReflection, texel, 0).rgb;
+
+      sum       += reflection * weight * bilinear;
+      weightSum += weight * bilinear;
+
+      if(weight > fallbackWeight){
+        fallbackWeight = weight;
+        fallback = reflection;
+      }
+    }
+
+    return weightSum > 1e-4 ? sum / weightSum : fallback;
+}
+
+void main(void)
+{
+    ivec2 coord = ivec2(gl_FragCoord.xy);
+
+    vec4 ColorSpec = texelFetch(texColSpec, coord, 0);
+    float Spec = ColorSpec.w == 1.0f? 0.0 : ColorSpec.w;
+
+    FragColor = vec4(ColorSpec.rgb, 1.0f);
+
+    // Same threshold as in SSR.frag, everything else was never traced
+    if(Spec > 0.2f){
+      FragColor.rgb += (uScale == 1) ? texelFetch(texReflection, coord, 0).rgb : upsample(coord);
+    }
+}
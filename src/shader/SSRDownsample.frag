@@ -0,0 +1,39 @@
+#version 420 core
+
+in vec2 tUV;
+
+layout(location = 0) out vec4 Position;
+layout(location = 1) out vec4 Normal;
+
+layout(binding = 0) uniform sampler2D texPos;
+layout(binding = 1) uniform sampler2D texNorm;
+layout(binding = 3) uniform sampler2D texDepth;
+
+uniform int uScale;
+
+/* Reduces the gBuffer to the trace resolution. Out of every uScale x uScale footprint the closest sample is kept,
+ * so thin foreground geometry survives and the reflection rays start on actual surfaces instead of averaged ones. */
+void main(void)
+{
+    ivec2 texSize = textureSize(texDepth, 0);
+    ivec2 base    = ivec2(gl_FragCoord.xy) * uScale;
+
+    ivec2 closest      = base;
+    float closestDepth = 2.0;
+
+    for(int y = 0; y < uScale; y++){
+      for(int x = 0; x < uScale; x++){
+        ivec2 texel = min(base + ivec2(x, y), texSize - 1);
+        float depth = texelFetch(texDepth, texel, 0).r;
+
+        if(depth < closestDepth){
+          closestDepth = depth;
+          closest = texel;
+        }
+      }
+    }
+
+    // w flags whether there is any geometry at all (sky stays at the cleared depth of 1.0)
+    Position = vec4(texelFetch(texPos, closest, 0).xyz, closestDepth < 1.0 ? 1.0 : 0.0);
+    Normal   = texelFetch(texNorm, closest, 0);
+}
@@ -0,0 +1,63 @@
+#version 420 core
+
+in vec2 tUV;
+
+layout(location = 0) out vec4 History;
+layout(location = 1) out float HistoryDepth;
+
+layout(binding = 0) uniform sampler2D texTracePos;
+layout(binding = 4) uniform sampler2D texReflection;
+layout(binding = 7) uniform sampler2D texHistory;
+layout(binding = 8) uniform sampler2D texHistoryDepth;
+
+uniform mat4 uView;
+uniform mat4 uPrevView;
+uniform mat4 uPrevViewProj;
+
+uniform bool  uHistoryValid;
+uniform float uBlend;
+
+/* Temporal accumulation of the traced reflections at trace resolution. The history of the last frame is reprojected
+ * with the previous view-projection, clamped to the neighbourhood of the current trace and blended in. History is
+ * dropped where the reprojected depth does not match anymore (disocclusion) or the pixel was off screen. */
+void main(void)
+{
+    ivec2 coord = ivec2(gl_FragCoord.xy);
+    ivec2 traceSize = textureSize(texReflection, 0);
+
+    vec3 Position = texelFetch(texTracePos, coord, 0).xyz;
+    vec4 current  = texelFetch(texReflection, coord, 0);
+
+    HistoryDepth = -(uView * vec4(Position, 1.0)).z;
+
+    // Neighbourhood of the current frame, history outside of it is considered outdated
+    vec4 minColor = current;
+    vec4 maxColor = current;
+    for(int y = -1; y <= 1; y++){
+      for(int x = -1; x <= 1; x++){
+        vec4 neighbour = texelFetch(texReflection, clamp(coord + ivec2(x, y), ivec2(0), traceSize - 1), 0);
+        minColor = min(minColor, neighbour);
+        maxColor = max(maxColor, neighbour);
+      }
+    }
+
+    vec4 prevClip = uPrevViewProj * vec4(Position, 1.0);
+    vec2 prevUV   = (prevClip.xy / prevClip.w) * 0.5 + 0.5;
+
+    bool valid = uHistoryValid && prevClip.w > 0.0 && all(greaterThanEqual(prevUV, vec2(0.0))) && all(lessThanEqual(prevUV, vec2(1.0)));
+
+    if(valid){
+      float expectedDepth = -(uPrevView * vec4(Position, 1.0)).z;
+      float prevDepth     = texture(texHistoryDepth, prevUV).r;
+
+      valid = abs(prevDepth - expectedDepth) < 0.05 * expectedDepth;
+    }
+
+    if(!valid){
+      History = current;
+      return;
+    }
+
+    vec4 history = clamp(texture(texHistory, prevUV), minColor, maxColor);
+    History = mix(history, current, uBlend);
+}
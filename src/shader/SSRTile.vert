@@ -0,0 +1,35 @@
+#version 430 core
+
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aUV;
+
+// Written by SSRClassify.comp
+layout(std430, binding = 0) readonly buffer TileList {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int  baseVertex;
+    uint baseInstance;
+
+    uint reflectiveTiles;
+    uint mixedTiles;
+
+    uint tiles[];
+};
+
+uniform vec2 uScreenSize;
+
+out vec2 tUV;
+
+const float TILE_SIZE = 16.0;
+
+// Places the quad over the listed tile of this instance, tiles are given in full resolution pixels
+void main(void)
+{
+    uint tile = tiles[gl_InstanceID];
+    vec2 origin = vec2(tile & 0xFFFFu, tile >> 16) * TILE_SIZE;
+
+    tUV = (origin + aUV * TILE_SIZE) / uScreenSize;
+    gl_Position = vec4(tUV * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -4,7 +4,10 @@ layout(location = 0) in vec3 aPosition;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aUV;
 
-uniform mat4 uModel;
+// affine model matrix, its columns are the rows of the transformation (see Affine3D)
+uniform mat3x4 uModel;
+// inverse transpose of uModel, computed once per draw on the CPU
+uniform mat3 uNormalMatrix;
 uniform mat4 uView;
 uniform mat4 uProj;
 
@@ -14,8 +17,8 @@ out vec2 tUV;
 
 void main(void)
 {
-    gl_Position = uProj * uView * uModel * vec4(aPosition, 1.0);
-    tFragPos = vec3(uModel * vec4(aPosition, 1.0));
-    tNormal = mat3(transpose(inverse(uModel))) * aNormal;
+    tFragPos = vec4(aPosition, 1.0) * uModel;
+    gl_Position = uProj * uView * vec4(tFragPos, 1.0);
+    tNormal = uNormalMatrix * aNormal;
     tUV = aUV;
 }
@@ -4,29 +4,48 @@ layout (location = 0) out vec4 gPosition;
 layout (location = 1) out vec4 gNormal;
 layout (location = 2) out vec4 gColorSpec;
 
-struct Material
-{
-    vec4 ambient;
-    vec3 diffuse;
-    vec4 specular;
-    float shininess;
-};
+// has to match MAX_DRAW_MATERIALS in vcproj.cpp
+#define MAX_MATERIALS 16
 
 in vec3 tFragPos;
 in vec3 tNormal;
+in vec2 tUV;
 
-uniform Material uMaterial;
+// materials of the ranges merged into this draw, range i ends before triangle uMaterialEnd[i]
+uniform int uMaterialCount;
+uniform int uMaterialEnd[MAX_MATERIALS];
+uniform vec3 uMaterialDiffuse[MAX_MATERIALS];
+uniform float uMaterialSpecular[MAX_MATERIALS];
+uniform int uMaterialLayer[MAX_MATERIALS];
 
-uniform float uSpec;
+// all textured materials of a draw share one array, layer -1 is untextured and layer -2 samples the plain 2D map
+// (streamed textures, which are never packed into arrays)
+uniform sampler2DArray uDiffuseMaps;
+uniform sampler2D uDiffuseMap;
 
 // Where is our Blinn-Phong? yes
 // This comment is just here so i can replace the bad commit message
 
 void main()
-{    
+{
     gNormal = vec4(normalize(tNormal), 1.0f);
     gPosition = vec4(tFragPos, 1.0f);
-    
-    gColorSpec = vec4(uMaterial.diffuse.rgb, uSpec);
-}  
 
+    int material = 0;
+    while(material < uMaterialCount - 1 && gl_PrimitiveID >= uMaterialEnd[material])
+    {
+        material++;
+    }
+
+    vec3 diffuse = uMaterialDiffuse[material];
+    if(uMaterialLayer[material] >= 0)
+    {
+        diffuse *= texture(uDiffuseMaps, vec3(tUV, uMaterialLayer[material])).rgb;
+    }
+    else if(uMaterialLayer[material] == -2)
+    {
+        diffuse *= texture(uDiffuseMap, tUV).rgb;
+    }
+
+    gColorSpec = vec4(diffuse, uMaterialSpecular[material]);
+}
@@ -0,0 +1,13 @@
+#version 330 core
+
+in vec2 tUV;
+in vec4 tColor;
+
+out vec4 FragColor;
+
+uniform sampler2D texFont;
+
+void main(void)
+{
+    FragColor = tColor * texture(texFont, tUV);
+}
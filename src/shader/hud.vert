@@ -0,0 +1,17 @@
+#version 330 core
+
+layout(location = 0) in vec2 aPosition;
+layout(location = 1) in vec2 aUV;
+layout(location = 2) in vec4 aColor;
+
+uniform mat4 uProj;
+
+out vec2 tUV;
+out vec4 tColor;
+
+void main(void)
+{
+    gl_Position = uProj * vec4(aPosition, 0.0, 1.0);
+    tUV = aUV;
+    tColor = aColor;
+}
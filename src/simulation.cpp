@@ -0,0 +1,176 @@
+#include "simulation.h"
+
+#include "mygl/cpuprofiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+
+namespace detail
+{
+
+void simulationApply(Simulation& sim, const InputEvent& event)
+{
+    switch(event.type)
+    {
+        case InputEvent::CONTROL:
+            sim.controls[event.control] = event.pressed;
+            break;
+        case InputEvent::ORBIT:
+            cameraUpdateOrbit(sim.camera, event.value, 0.0f);
+            break;
+        case InputEvent::ZOOM:
+            cameraUpdateOrbit(sim.camera, {0.0f, 0.0f}, event.value.x);
+            break;
+        case InputEvent::CAMERA_RESET:
+            sim.cameraFollowHeli = false;
+            sim.camera.lookAt = {0.0f, 0.0f, 0.0f};
+            cameraUpdateOrbit(sim.camera, {0.0f, 0.0f}, 0.0f);
+            break;
+        case InputEvent::CAMERA_FOLLOW:
+            sim.cameraFollowHeli = event.pressed;
+            break;
+        case InputEvent::RESIZE:
+            sim.camera.width = event.value.x;
+            sim.camera.height = event.value.y;
+            break;
+    }
+}
+
+void simulationPublish(Simulation& sim)
+{
+    SceneSnapshot& snapshot = tripleBufferBack(sim.snapshots);
+    snapshot.heliPosition[0] = sim.heli.prevPosition;
+    snapshot.heliPosition[1] = sim.heli.position;
+    snapshot.heliAngles[0] = sim.heli.prevAngles;
+    snapshot.heliAngles[1] = sim.heli.angles;
+    snapshot.heliRotorRotation[0] = sim.heli.prevRotorRotation;
+    snapshot.heliRotorRotation[1] = sim.heli.rotorRotation;
+    snapshot.time = sim.time;
+    snapshot.step = sim.stepCount;
+    snapshot.camera = sim.camera;
+    snapshot.cameraFollowHeli = sim.cameraFollowHeli;
+
+    tripleBufferPublish(sim.snapshots);
+}
+
+void simulationRun(Simulation& sim)
+{
+    PROFILE_THREAD("simulation");
+
+    InputEvent event;
+    bool pending = false;
+
+    while(sim.running.load(std::memory_order_acquire))
+    {
+        {
+            PROFILE_ZONE("simulationUpdate");
+
+            double now = simulationTime();
+            unsigned int steps = 0;
+            while(sim.time + sim.step <= now && steps < sim.maxSteps)
+            {
+                double stepEnd = sim.time + sim.step;
+
+                /* input that happened during this step is applied before it, later events wait for their step */
+                while(pending || spscPop(sim.input, event))
+                {
+                    pending = event.time > stepEnd;
+                    if(pending)
+                    {
+                        break;
+                    }
+                    simulationApply(sim, event);
+                }
+
+                helicopterMove(sim.heli, sim.controls, sim.step);
+                if(sim.cameraFollowHeli)
+                {
+                    cameraFollow(sim.camera, sim.heli.position);
+                }
+
+                sim.time = stepEnd;
+                sim.stepCount++;
+                steps++;
+            }
+
+            /* too far behind, drop the backlog instead of catching up over the next wake ups */
+            if(sim.time + sim.step <= now)
+            {
+                sim.time = now - std::fmod(now - sim.time, sim.step);
+            }
+
+            if(steps > 0)
+            {
+                simulationPublish(sim);
+            }
+        }
+
+        double wait = sim.time + sim.step - simulationTime();
+        if(wait > 0.0)
+        {
+            std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+        }
+    }
+}
+
+}
+
+double simulationTime()
+{
+    return cpuProfilerNow() * 1e-9;
+}
+
+void simulationStart(Simulation& sim, const Helicopter& heli, const Camera& camera, bool cameraFollowHeli)
+{
+    if(sim.running.load())
+    {
+        throw std::runtime_error("[Simulation] already running!");
+    }
+
+    sim.heli = heli;
+    sim.heli.partModel.clear();
+    sim.heli.prevPosition = heli.position;
+    sim.heli.prevAngles = heli.angles;
+    sim.heli.prevRotorRotation = heli.rotorRotation;
+    sim.camera = camera;
+    sim.cameraFollowHeli = cameraFollowHeli;
+    std::fill(std::begin(sim.controls), std::end(sim.controls), false);
+    sim.time = simulationTime();
+
+    /* the renderer always finds a snapshot, even before the first step */
+    detail::simulationPublish(sim);
+
+    sim.running.store(true, std::memory_order_release);
+    sim.thread = std::thread(detail::simulationRun, std::ref(sim));
+}
+
+void simulationPush(Simulation& sim, const InputEvent& event)
+{
+    if(!spscPush(sim.input, event))
+    {
+        /* the simulation drains the queue every step, this only happens if it hangs */
+        if(sim.inputDropped++ == 0)
+        {
+            std::cerr << "[Simulation] input queue full, dropping events" << std::endl;
+        }
+    }
+}
+
+const SceneSnapshot& simulationSnapshot(Simulation& sim)
+{
+    tripleBufferAcquire(sim.snapshots);
+    return tripleBufferFront(sim.snapshots);
+}
+
+void simulationStop(Simulation& sim)
+{
+    sim.running.store(false, std::memory_order_release);
+    if(sim.thread.joinable())
+    {
+        sim.thread.join();
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "mygl/base.h"
+#include "mygl/camera.h"
+#include "mygl/spscqueue.h"
+#include "mygl/triplebuffer.h"
+
+#include "helicopter.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+struct InputEvent
+{
+    enum eType
+    {
+        CONTROL = 0,    /* helicopter control `control` pressed or released */
+        ORBIT,          /* camera orbit by `value` pixels */
+        ZOOM,           /* camera zoom by `value.x` */
+        CAMERA_RESET,   /* stop following and look at the origin */
+        CAMERA_FOLLOW,  /* follow the helicopter if `pressed` */
+        RESIZE          /* window resized to `value` */
+    };
+
+    eType type = CONTROL;
+
+    /* seconds of simulationTime() at which the event happened */
+    double time = 0.0;
+
+    int control = 0;
+    bool pressed = false;
+    Vector2D value;
+};
+
+/* everything the renderer needs from one simulation step, copied so the simulation can move on while it is drawn */
+struct SceneSnapshot
+{
+    /* helicopter state before [0] and after [1] the newest step */
+    Vector3D heliPosition[2];
+    Vector3D heliAngles[2];
+    float heliRotorRotation[2] = {};
+
+    /* seconds of simulationTime() the newest step simulated up to */
+    double time = 0.0;
+    std::uint64_t step = 0;
+
+    Camera camera = {};
+    bool cameraFollowHeli = true;
+};
+
+struct Simulation
+{
+    /* fixed step and upper limit of steps per wake up, a backlog beyond that is dropped */
+    double step = 1.0 / 120.0;
+    unsigned int maxSteps = 8;
+
+    /* filled by the glfw callbacks on the main thread, drained by the simulation thread */
+    SpscQueue<InputEvent, 1024> input;
+    unsigned int inputDropped = 0;
+
+    /* written by the simulation thread, read by the render thread */
+    TripleBuffer<SceneSnapshot> snapshots;
+
+    /* owned by the simulation thread while it runs */
+    Helicopter heli;
+    Camera camera = {};
+    bool cameraFollowHeli = true;
+    bool controls[Helicopter::CONTROL_COUNT] = {};
+    double time = 0.0;
+    std::uint64_t stepCount = 0;
+
+    std::atomic<bool> running{false};
+    std::thread thread;
+};
+
+/**
+ * @brief Time base of the simulation and of input events.
+ *
+ * @return Seconds since the start of the program (steady clock).
+ */
+double simulationTime();
+
+/**
+ * @brief Starts simulating the helicopter and camera on a separate thread, beginning at the given state. The simulation
+ * advances in fixed steps of wall clock time and publishes a snapshot after every wake up.
+ *
+ * @param sim Simulation, must not be running.
+ * @param heli Initial helicopter state (its models are not used).
+ * @param camera Initial camera.
+ * @param cameraFollowHeli Whether the camera initially follows the helicopter.
+ */
+void simulationStart(Simulation& sim, const Helicopter& heli, const Camera& camera, bool cameraFollowHeli);
+
+/**
+ * @brief Hands an input event to the simulation thread without blocking. Must only be called from one thread.
+ *
+ * @param sim Simulation.
+ * @param event Event, applied at the first step ending after its time.
+ */
+void simulationPush(Simulation& sim, const InputEvent& event);
+
+/**
+ * @brief Returns the newest snapshot published by the simulation thread. Must only be called from one thread.
+ *
+ * @param sim Simulation.
+ *
+ * @return Snapshot that stays valid and unchanged until the next call.
+ */
+const SceneSnapshot& simulationSnapshot(Simulation& sim);
+
+/**
+ * @brief Stops and joins the simulation thread.
+ *
+ * @param sim Simulation.
+ */
+void simulationStop(Simulation& sim);
@@ -0,0 +1,498 @@
+#include "ssr.h"
+
+#include "mygl/geometry.h"
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace detail
+{
+
+/* DrawElementsIndirectCommand followed by the reflective and mixed tile counters, see SSRClassify.comp */
+constexpr unsigned int TILE_HEADER = 7;
+
+GLuint ssrTarget(GLenum attachment, GLint internalFormat, GLenum format, GLenum type, unsigned int width, unsigned int height, GLint filter = GL_NEAREST)
+{
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texture, 0);
+    glCheckError();
+
+    return texture;
+}
+
+void ssrCheckFramebuffer()
+{
+    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "[SSR] trace target is not a valid framebuffer (incomplete)!" << std::endl;
+        std::cerr.flush();
+        throw std::runtime_error("[SSR] trace target is not a valid framebuffer (incomplete)!");
+    }
+}
+
+unsigned int ssrTraceSize(unsigned int size, int scale)
+{
+    return (size + scale - 1) / scale;
+}
+
+void ssrCreateTargets(SSR& ssr)
+{
+    unsigned int width = ssrTraceSize(ssr.width, ssr.scale);
+    unsigned int height = ssrTraceSize(ssr.height, ssr.scale);
+
+    if(ssr.scale != SSR::FULL)
+    {
+        glGenFramebuffers(1, &ssr.traceFbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, ssr.traceFbo);
+
+        ssr.tracePosition = ssrTarget(GL_COLOR_ATTACHMENT0, GL_RGBA16F, GL_RGBA, GL_FLOAT, width, height);
+        ssr.traceNormal = ssrTarget(GL_COLOR_ATTACHMENT1, GL_RGBA16F, GL_RGBA, GL_FLOAT, width, height);
+
+        GLuint buffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+        glDrawBuffers(2, buffers);
+        ssrCheckFramebuffer();
+    }
+
+    /* own stencil buffer, the one of the gBuffer only fits at full resolution and is sampled as depth by the trace */
+    glGenRenderbuffers(1, &ssr.traceStencil);
+    glBindRenderbuffer(GL_RENDERBUFFER, ssr.traceStencil);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &ssr.reflectionFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, ssr.reflectionFbo);
+    ssr.reflection = ssrTarget(GL_COLOR_ATTACHMENT0, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, ssr.traceStencil);
+    ssrCheckFramebuffer();
+
+    /* history is sampled at reprojected (sub-pixel) positions, hence linear filtering for the color */
+    glGenFramebuffers(2, ssr.historyFbo);
+    for(int i = 0; i < 2; i++)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, ssr.historyFbo[i]);
+        ssr.history[i] = ssrTarget(GL_COLOR_ATTACHMENT0, GL_RGBA16F, GL_RGBA, GL_FLOAT, width, height, GL_LINEAR);
+        ssr.historyDepth[i] = ssrTarget(GL_COLOR_ATTACHMENT1, GL_R32F, GL_RED, GL_FLOAT, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, ssr.traceStencil);
+
+        GLuint buffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+        glDrawBuffers(2, buffers);
+        ssrCheckFramebuffer();
+    }
+    ssr.historyValid = false;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    /* tile list: indirect draw arguments, two counters and one entry per tile */
+    if(ssr.tilesSupported)
+    {
+        ssr.tilesX = (ssr.width + SSR::TILE_SIZE - 1) / SSR::TILE_SIZE;
+        ssr.tilesY = (ssr.height + SSR::TILE_SIZE - 1) / SSR::TILE_SIZE;
+
+        glGenBuffers(1, &ssr.tileBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssr.tileBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, (TILE_HEADER + ssr.tilesX * ssr.tilesY) * sizeof(GLuint), NULL, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        glCheckError();
+    }
+}
+
+void ssrDeleteTargets(SSR& ssr)
+{
+    glDeleteTextures(1, &ssr.tracePosition);
+    glDeleteTextures(1, &ssr.traceNormal);
+    glDeleteTextures(1, &ssr.reflection);
+    glDeleteFramebuffers(1, &ssr.traceFbo);
+    glDeleteFramebuffers(1, &ssr.reflectionFbo);
+    glDeleteRenderbuffers(1, &ssr.traceStencil);
+    glDeleteTextures(2, ssr.history);
+    glDeleteTextures(2, ssr.historyDepth);
+    glDeleteFramebuffers(2, ssr.historyFbo);
+    glDeleteBuffers(1, &ssr.tileBuffer);
+
+    ssr.tracePosition = ssr.traceNormal = ssr.reflection = 0;
+    ssr.traceFbo = ssr.reflectionFbo = ssr.traceStencil = 0;
+    ssr.history[0] = ssr.history[1] = ssr.historyDepth[0] = ssr.historyDepth[1] = 0;
+    ssr.historyFbo[0] = ssr.historyFbo[1] = 0;
+    ssr.tileBuffer = 0;
+}
+
+/* adds the newest gpu time of the ssr pass to the scale and mode its frame was drawn with */
+void ssrCollectTimings(SSR& ssr, const GpuProfiler& profiler)
+{
+    float ms = 0.0f;
+    unsigned int frame = 0;
+    if(!gpuProfilerLatest(profiler, "ssr", ms, frame) || frame == ssr.measuredFrame ||
+       profiler.frame - frame >= SSR::TAG_COUNT)
+    {
+        return;
+    }
+
+    int tag = ssr.tags[frame % SSR::TAG_COUNT];
+    ssr.timeMs[tag / (SSR::QUARTER + 1)][tag % (SSR::QUARTER + 1)] += ms;
+    ssr.timeSamples[tag / (SSR::QUARTER + 1)][tag % (SSR::QUARTER + 1)]++;
+    ssr.measuredFrame = frame;
+}
+
+void ssrReportScale(const SSR& ssr, int scale)
+{
+    for(int tiled = 0; tiled < 2; tiled++)
+    {
+        if(ssr.timeSamples[tiled][scale] == 0)
+        {
+            continue;
+        }
+
+        std::cout << "[SSR] trace scale 1/" << scale << (tiled ? " (tiled)" : "") << ": "
+                  << ssr.timeMs[tiled][scale] / ssr.timeSamples[tiled][scale]
+                  << " ms avg GPU time over " << ssr.timeSamples[tiled][scale] << " frames" << std::endl;
+    }
+}
+
+/* reset the tile list and classify the colorSpec attachment of the gBuffer */
+void ssrClassifyTiles(SSR& ssr, const GBuffer& gb)
+{
+    const GLuint header[TILE_HEADER] = {6, 0, 0, 0, 0, 0, 0};
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssr.tileBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(header), header);
+
+    glUseProgram(ssr.shaderClassify.id);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, gb.colorSpec);
+
+    glDispatchCompute(ssr.tilesX, ssr.tilesY, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+}
+
+/* draws the pass either as a full screen quad or as one quad per listed tile */
+void ssrDrawCover(SSR& ssr, ShaderProgram& program, bool tiled)
+{
+    ssr.drawCalls++;
+
+    if(tiled)
+    {
+        shaderUniform(program, "uScreenSize", Vector2D(ssr.width, ssr.height));
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, ssr.tileBuffer);
+        glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*) 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+    else
+    {
+        glDrawElements(GL_TRIANGLES, ssr.quad.size_ibo, GL_UNSIGNED_INT, (void*) 0);
+    }
+}
+
+}
+
+SSR ssrCreate(unsigned int width, unsigned int height, int scale)
+{
+    assert(scale == SSR::FULL || scale == SSR::HALF || scale == SSR::QUARTER);
+
+    SSR ssr;
+    ssr.width = width;
+    ssr.height = height;
+    ssr.scale = scale;
+
+    ssr.shaderDownsample = shaderLoad("shader/quad.vert", "shader/SSRDownsample.frag");
+    ssr.shaderTrace = shaderLoad("shader/quad.vert", "shader/SSR.frag");
+    ssr.shaderTemporal = shaderLoad("shader/quad.vert", "shader/SSRTemporal.frag");
+    ssr.shaderComposite = shaderLoad("shader/quad.vert", "shader/SSRComposite.frag");
+
+    /* compute shaders, storage buffers and glMemoryBarrier are core only since 4.3, the context asks for 3.3 */
+    ssr.tilesSupported = GLAD_GL_ARB_compute_shader && GLAD_GL_ARB_shader_storage_buffer_object &&
+                         GLAD_GL_ARB_shader_image_load_store && GLAD_GL_ARB_draw_indirect;
+    if(ssr.tilesSupported)
+    {
+        ssr.shaderClassify = shaderLoadCompute("shader/SSRClassify.comp");
+        ssr.shaderTraceTiles = shaderLoad("shader/SSRTile.vert", "shader/SSR.frag");
+        ssr.shaderTemporalTiles = shaderLoad("shader/SSRTile.vert", "shader/SSRTemporal.frag");
+        ssr.shaderCompositeTiles = shaderLoad("shader/SSRTile.vert", "shader/SSRComposite.frag");
+    }
+    else
+    {
+        std::cout << "[SSR] no compute shader support, tile classification disabled" << std::endl;
+    }
+
+    ssr.quad = meshCreate(quad::vertices, quad::indices);
+
+    detail::ssrCreateTargets(ssr);
+
+    return ssr;
+}
+
+void ssrSetScale(SSR& ssr, int scale)
+{
+    assert(scale == SSR::FULL || scale == SSR::HALF || scale == SSR::QUARTER);
+
+    if(scale == ssr.scale)
+    {
+        return;
+    }
+
+    detail::ssrReportScale(ssr, ssr.scale);
+
+    detail::ssrDeleteTargets(ssr);
+    ssr.scale = scale;
+    detail::ssrCreateTargets(ssr);
+}
+
+void ssrResize(SSR& ssr, unsigned int width, unsigned int height)
+{
+    if(width == ssr.width && height == ssr.height)
+    {
+        return;
+    }
+
+    detail::ssrDeleteTargets(ssr);
+    ssr.width = width;
+    ssr.height = height;
+    detail::ssrCreateTargets(ssr);
+}
+
+void ssrSetTemporal(SSR& ssr, bool temporal)
+{
+    ssr.temporal = temporal;
+    ssr.historyValid = false;
+}
+
+void ssrSetTiled(SSR& ssr, bool tiled)
+{
+    ssr.tiled = tiled;
+}
+
+void ssrDraw(SSR& ssr, GpuProfiler& profiler, const GBuffer& gb, const Matrix4D& proj, const Matrix4D& view, const Matrix4D& prevProj, const Matrix4D& prevView)
+{
+    assert(gb.width == ssr.width && gb.height == ssr.height);
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    GLint target = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+    GLint source = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &source);
+
+    unsigned int width = detail::ssrTraceSize(ssr.width, ssr.scale);
+    unsigned int height = detail::ssrTraceSize(ssr.height, ssr.scale);
+
+    bool tiled = ssr.tiled && ssr.tilesSupported;
+    ShaderProgram& shaderTrace = tiled ? ssr.shaderTraceTiles : ssr.shaderTrace;
+    ShaderProgram& shaderTemporal = tiled ? ssr.shaderTemporalTiles : ssr.shaderTemporal;
+    ShaderProgram& shaderComposite = tiled ? ssr.shaderCompositeTiles : ssr.shaderComposite;
+
+    gpuProfilerBegin(profiler, "ssr");
+    ssr.tags[profiler.frame % SSR::TAG_COUNT] = tiled * (SSR::QUARTER + 1) + ssr.scale;
+    ssr.drawCalls = 0;
+
+    if(tiled)
+    {
+        detail::ssrClassifyTiles(ssr, gb);
+    }
+
+    glDisable(GL_DEPTH_TEST);
+    glBindVertexArray(ssr.quad.vao);
+    glViewport(0, 0, width, height);
+
+    /* reduce position and normals to the trace resolution. Rays leave their tile, so this still covers the whole screen */
+    GLuint position = gb.position;
+    GLuint normal = gb.normal;
+    if(ssr.scale != SSR::FULL)
+    {
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, ssr.traceFbo);
+        glUseProgram(ssr.shaderDownsample.id);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, gb.position);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, gb.normal);
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_2D, gb.depthStencil);
+
+        shaderUniform(ssr.shaderDownsample, "uScale", ssr.scale);
+
+        ssr.drawCalls++;
+        glDrawElements(GL_TRIANGLES, ssr.quad.size_ibo, GL_UNSIGNED_INT, (void*) 0);
+
+        position = ssr.tracePosition;
+        normal = ssr.traceNormal;
+    }
+
+    /* reduce the stencil to the trace resolution, from here on only reflective pixels pass the stencil test */
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, gb.fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, ssr.reflectionFbo);
+    glStencilMask(0xFF);
+    glBlitFramebuffer(0, 0, ssr.width, ssr.height, 0, 0, width, height, GL_STENCIL_BUFFER_BIT, GL_NEAREST);
+
+    glEnable(GL_STENCIL_TEST);
+    glStencilMask(0x00);
+    glStencilFunc(GL_EQUAL, SSR::STENCIL_REFLECTIVE, SSR::STENCIL_REFLECTIVE);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+
+    /* trace reflections into their own texture */
+    {
+        const GLfloat noHit[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        glClearBufferfv(GL_COLOR, 0, noHit);
+
+        glUseProgram(shaderTrace.id);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, position);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, normal);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, gb.colorSpec);
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_2D, gb.depthStencil);
+
+        shaderUniform(shaderTrace, "uProj",  proj);
+        shaderUniform(shaderTrace, "uInvProj",  inverse(proj));
+        shaderUniform(shaderTrace, "uMaxDistance", ssr.maxDistance);
+        shaderUniform(shaderTrace, "uSteps", ssr.steps);
+        shaderUniform(shaderTrace, "uThickness", ssr.thickness);
+
+        /* golden ratio sequence, so the stride offsets of consecutive frames are well distributed */
+        shaderUniform(shaderTrace, "uStride", ssr.temporal ? ssr.temporalStride : 1);
+        shaderUniform(shaderTrace, "uJitter", ssr.temporal ? std::fmod(ssr.frame * 0.618034f, 1.0f) : 0.0f);
+
+        detail::ssrDrawCover(ssr, shaderTrace, tiled);
+    }
+
+    /* accumulate with the reprojected history of the previous frame */
+    GLuint reflection = ssr.reflection;
+    if(ssr.temporal)
+    {
+        unsigned int previous = ssr.historyIndex;
+        unsigned int current = previous ^ 1;
+
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, ssr.historyFbo[current]);
+        glUseProgram(shaderTemporal.id);
+
+        /* pixels rejected by the stencil test or an unlisted tile keep a zero depth, so their history gets rejected
+         * once they turn reflective */
+        const GLfloat empty[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        glClearBufferfv(GL_COLOR, 0, empty);
+        glClearBufferfv(GL_COLOR, 1, empty);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, position);
+        glActiveTexture(GL_TEXTURE4);
+        glBindTexture(GL_TEXTURE_2D, ssr.reflection);
+        glActiveTexture(GL_TEXTURE7);
+        glBindTexture(GL_TEXTURE_2D, ssr.history[previous]);
+        glActiveTexture(GL_TEXTURE8);
+        glBindTexture(GL_TEXTURE_2D, ssr.historyDepth[previous]);
+
+        shaderUniform(shaderTemporal, "uView", view);
+        shaderUniform(shaderTemporal, "uPrevView", prevView);
+        shaderUniform(shaderTemporal, "uPrevViewProj", prevProj * prevView);
+        shaderUniform(shaderTemporal, "uHistoryValid", ssr.historyValid);
+        shaderUniform(shaderTemporal, "uBlend", ssr.temporalBlend);
+
+        detail::ssrDrawCover(ssr, shaderTemporal, tiled);
+
+        ssr.historyIndex = current;
+        ssr.historyValid = true;
+        reflection = ssr.history[current];
+    }
+    ssr.frame++;
+
+    /* upsample and add reflections onto the scene color in the light buffer */
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gb.lightFbo);
+    glViewport(0, 0, ssr.width, ssr.height);
+    {
+        /* non reflective pixels are rejected by the stencil test, their color is copied as is */
+        glReadBuffer(GL_COLOR_ATTACHMENT2);
+        glBlitFramebuffer(0, 0, ssr.width, ssr.height, 0, 0, ssr.width, ssr.height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+        /* the alpha channel holds the specular factor, the composite writes an opaque color */
+        const GLfloat opaque[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_TRUE);
+        glClearBufferfv(GL_COLOR, 0, opaque);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+        glUseProgram(shaderComposite.id);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, gb.position);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, gb.normal);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, gb.colorSpec);
+        glActiveTexture(GL_TEXTURE4);
+        glBindTexture(GL_TEXTURE_2D, reflection);
+        glActiveTexture(GL_TEXTURE5);
+        glBindTexture(GL_TEXTURE_2D, ssr.tracePosition);
+        glActiveTexture(GL_TEXTURE6);
+        glBindTexture(GL_TEXTURE_2D, ssr.traceNormal);
+        glActiveTexture(GL_TEXTURE0);
+
+        shaderUniform(shaderComposite, "uView", view);
+        shaderUniform(shaderComposite, "uScale", ssr.scale);
+
+        detail::ssrDrawCover(ssr, shaderComposite, tiled);
+    }
+
+    glDisable(GL_STENCIL_TEST);
+    glStencilMask(0xFF);
+    glBindVertexArray(0);
+
+    /* copy the light buffer into the original target */
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, gb.lightFbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glBlitFramebuffer(0, 0, ssr.width, ssr.height, viewport[0], viewport[1], viewport[0] + viewport[2], viewport[1] + viewport[3], GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, source);
+
+    gpuProfilerEnd(profiler);
+    detail::ssrCollectTimings(ssr, profiler);
+}
+
+std::size_t ssrMemory(const SSR& ssr)
+{
+    std::size_t width = detail::ssrTraceSize(ssr.width, ssr.scale);
+    std::size_t height = detail::ssrTraceSize(ssr.height, ssr.scale);
+
+    /* reflection (RGBA8), stencil (D24S8), two histories (RGBA16F + R32F) and the downsampled position + normal */
+    std::size_t perPixel = 4 + 4 + 2 * (8 + 4) + (ssr.scale != SSR::FULL ? 8 + 8 : 0);
+    std::size_t tiles = ssr.tileBuffer ? (detail::TILE_HEADER + ssr.tilesX * ssr.tilesY) * sizeof(GLuint) : 0;
+
+    return width * height * perPixel + tiles;
+}
+
+void ssrReport(SSR& ssr, const GpuProfiler& profiler)
+{
+    detail::ssrCollectTimings(ssr, profiler);
+
+    for(int scale : {SSR::FULL, SSR::HALF, SSR::QUARTER})
+    {
+        detail::ssrReportScale(ssr, scale);
+    }
+}
+
+void ssrDelete(SSR& ssr)
+{
+    detail::ssrDeleteTargets(ssr);
+
+    shaderDelete(ssr.shaderDownsample);
+    shaderDelete(ssr.shaderTrace);
+    shaderDelete(ssr.shaderTemporal);
+    shaderDelete(ssr.shaderComposite);
+
+    if(ssr.tilesSupported)
+    {
+        shaderDelete(ssr.shaderClassify);
+        shaderDelete(ssr.shaderTraceTiles);
+        shaderDelete(ssr.shaderTemporalTiles);
+        shaderDelete(ssr.shaderCompositeTiles);
+    }
+
+    meshDelete(ssr.quad);
+}
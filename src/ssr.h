@@ -0,0 +1,178 @@
+#pragma once
+
+#include "mygl/base.h"
+#include "mygl/mesh.h"
+#include "mygl/shader.h"
+#include "mygl/gbuffer.h"
+#include "mygl/gpuprofiler.h"
+
+struct SSR
+{
+    enum eScale
+    {
+        FULL = 1,
+        HALF = 2,
+        QUARTER = 4
+    };
+
+    int scale = FULL;
+
+    /* pixels above this specular factor get reflections (same threshold as in the shaders). The geometry pass tags them
+     * with this stencil bit, so the deferred passes can reject everything else before the fragment shader runs */
+    static constexpr float SPEC_THRESHOLD = 0.2f;
+    static constexpr GLint STENCIL_REFLECTIVE = 1;
+
+    /* trace parameters, see SSR.frag */
+    float maxDistance = 15.0f;
+    int steps = 10;
+    float thickness = 0.5f;
+
+    /* temporal accumulation, only every stride-th step of the ray march is tested per frame */
+    bool temporal = true;
+    int temporalStride = 4;
+    float temporalBlend = 0.1f;
+
+    /* resolution of the gBuffer / output */
+    unsigned int width = 0;
+    unsigned int height = 0;
+
+    /* downsampled position + normal, only allocated if scale != FULL */
+    GLuint traceFbo = 0;
+    GLuint tracePosition = 0;
+    GLuint traceNormal = 0;
+
+    /* reflection color (rgb) and hit flag (a) at trace resolution */
+    GLuint reflectionFbo = 0;
+    GLuint reflection = 0;
+
+    /* stencil of the gBuffer reduced to the trace resolution, attached to the reflection and history targets */
+    GLuint traceStencil = 0;
+
+    /* accumulated reflection (rgba) and linear view depth (r) at trace resolution, ping-ponged every frame */
+    GLuint historyFbo[2] = {};
+    GLuint history[2] = {};
+    GLuint historyDepth[2] = {};
+    unsigned int historyIndex = 0;
+    bool historyValid = false;
+    unsigned int frame = 0;
+
+    /* 16x16 screen tiles are classified each frame and only tiles with reflective pixels are traced and composited.
+     * Needs compute shaders, storage buffers and indirect draws, otherwise every pass covers the whole screen */
+    static constexpr unsigned int TILE_SIZE = 16;
+    bool tiled = true;
+    bool tilesSupported = false;
+    unsigned int tilesX = 0;
+    unsigned int tilesY = 0;
+    GLuint tileBuffer = 0;
+
+    ShaderProgram shaderDownsample;
+    ShaderProgram shaderTrace;
+    ShaderProgram shaderTemporal;
+    ShaderProgram shaderComposite;
+
+    /* same passes, drawn as one instanced quad per listed tile */
+    ShaderProgram shaderClassify;
+    ShaderProgram shaderTraceTiles;
+    ShaderProgram shaderTemporalTiles;
+    ShaderProgram shaderCompositeTiles;
+
+    Mesh quad;
+
+    /* draw calls issued by the last ssrDraw */
+    unsigned int drawCalls = 0;
+
+    /* gpu time of the "ssr" profiler pass, accumulated per scale for full screen [0] and tiled [1] passes. Results
+     * arrive a few frames late, so the configuration every frame in flight was drawn with is kept, indexed by the
+     * profiler frame */
+    static constexpr unsigned int TAG_COUNT = 2 * GpuProfiler::FRAME_COUNT;
+    int tags[TAG_COUNT] = {};
+    unsigned int measuredFrame = ~0u;
+    double timeMs[2][QUARTER + 1] = {};
+    unsigned int timeSamples[2][QUARTER + 1] = {};
+};
+
+/**
+ * @brief Creates all shaders and render targets for screen-space reflections.
+ *
+ * @param width Width of the gBuffer that gets traced.
+ * @param height Height of the gBuffer that gets traced.
+ * @param scale Divisor of the trace resolution (SSR::FULL, SSR::HALF or SSR::QUARTER).
+ *
+ * @return Initialized ssr pass.
+ */
+SSR ssrCreate(unsigned int width, unsigned int height, int scale = SSR::FULL);
+
+/**
+ * @brief Changes the trace resolution and reallocates the trace targets. Prints the average GPU time measured for the
+ * previous scale.
+ *
+ * @param ssr SSR pass to change.
+ * @param scale New divisor of the trace resolution.
+ */
+void ssrSetScale(SSR& ssr, int scale);
+
+/**
+ * @brief Traces reflections for the given gBuffer and composites them onto its color. Only pixels tagged with
+ * SSR::STENCIL_REFLECTIVE in the stencil buffer of the gBuffer are traced. The result is written into the light buffer
+ * of the gBuffer and then copied into the viewport of the framebuffer currently bound to GL_DRAW_FRAMEBUFFER. The GPU
+ * time is measured as the "ssr" pass of the profiler.
+ *
+ * @param ssr SSR pass.
+ * @param profiler Gpu profiler of the current frame.
+ * @param gb GBuffer holding the scene.
+ * @param proj Projection matrix the gBuffer was rendered with.
+ * @param view View matrix the gBuffer was rendered with.
+ * @param prevProj Projection matrix of the previous frame (used to reproject the reflection history).
+ * @param prevView View matrix of the previous frame (used to reproject the reflection history).
+ */
+void ssrDraw(SSR& ssr, GpuProfiler& profiler, const GBuffer& gb, const Matrix4D& proj, const Matrix4D& view, const Matrix4D& prevProj, const Matrix4D& prevView);
+
+/**
+ * @brief Changes the size of the traced gBuffer and reallocates all size dependent targets. Starts from an empty
+ * history.
+ *
+ * @param ssr SSR pass to change.
+ * @param width New width of the gBuffer.
+ * @param height New height of the gBuffer.
+ */
+void ssrResize(SSR& ssr, unsigned int width, unsigned int height);
+
+/**
+ * @brief Enables or disables temporal accumulation. Enabling it starts from an empty history.
+ *
+ * @param ssr SSR pass to change.
+ * @param temporal Whether reflections are accumulated over several frames.
+ */
+void ssrSetTemporal(SSR& ssr, bool temporal);
+
+/**
+ * @brief Enables or disables the tile classification. Has no effect if the context lacks compute shader support.
+ *
+ * @param ssr SSR pass to change.
+ * @param tiled Whether only tiles containing reflective pixels are traced.
+ */
+void ssrSetTiled(SSR& ssr, bool tiled);
+
+/**
+ * @brief Computes the video memory used by the trace targets, history and tile list of the ssr pass.
+ *
+ * @param ssr SSR pass.
+ *
+ * @return Size in bytes.
+ */
+std::size_t ssrMemory(const SSR& ssr);
+
+/**
+ * @brief Prints the average GPU time of every trace scale that was used so far.
+ *
+ * @param ssr SSR pass.
+ * @param profiler Gpu profiler the pass was measured with.
+ */
+void ssrReport(SSR& ssr, const GpuProfiler& profiler);
+
+/**
+ * @brief Cleanup and delete all OpenGL objects of the ssr pass.
+ *
+ * @param ssr SSR pass to delete.
+ */
+void ssrDelete(SSR& ssr);
@@ -1,11 +1,28 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 #include "mygl/shader.h"
 #include "mygl/model.h"
+#include "mygl/registry.h"
 #include "mygl/camera.h"
+#include "mygl/gbuffer.h"
+#include "mygl/framebuffer.h"
+#include "mygl/offscreen.h"
+#include "mygl/screenshot.h"
+#include "mygl/capture.h"
+#include "mygl/gpuprofiler.h"
+#include "mygl/cpuprofiler.h"
 
 #include "helicopter.h"
+#include "ssr.h"
+#include "dynres.h"
+#include "hud.h"
+#include "benchmark.h"
+#include "simulation.h"
 
 struct
 {
@@ -13,107 +30,130 @@ struct
     bool cameraFollowHeli;
     float zoomSpeedMultiplier;
 
+    /* materials and textures shared by all models */
+    Registry registry;
+
+    /* draw consecutive ranges of a model with one call, toggled with B */
+    bool batchMaterials = true;
+
     Helicopter heli;
     Model modelGround;
 
-    ShaderProgram shaderSSR;
+    /* the helicopter and camera are simulated in fixed steps on their own thread, the render thread only picks up
+     * snapshots. The benchmark steps the same parameters synchronously (sceneUpdate), so its runs stay reproducible */
+    Simulation sim;
+
+    /* time of sceneUpdate that is left over for the next frame, used to interpolate the rendered state */
+    double simAccumulator = 0.0;
+
     ShaderProgram shaderGBuffer;
 
-    int width = 1280;
-    int height = 720;
-} sScene;
+    GBuffer gBuffer;
+    SSR ssr;
 
-// Global variables rule
-GLuint gBuffer, gPosition, gNormal, gColorSpec, gDepth;
-GLuint vao_quad = 0, vbo_quad = 0, ebo_quad = 0;
+    /* gBuffer and ssr render at a fraction of the window size that follows the GPU frame time */
+    DynamicResolution dynres;
 
-/* Define information for quad, sourced from example 09_framebuffer */
-enum eIndex {position = 0, color = 1, uV = 2};
+    GpuProfiler gpuProfiler;
 
-// Names changed to avoid conflict with definitions in mesh.h
-struct Vex
-{
-    GLfloat position[3];
-    GLfloat color[3];
-    GLfloat uv[2];
-};
+    /* screenshots are read back and encoded without stalling the frame */
+    ScreenshotQueue screenshots;
 
-// Color values should not be needed, as quad should be filled using texture (will change this when we get the rest working)
-const std::vector<Vex> vertices_quad =
-{
-    /* position */          /* color */         /* uv */
-    {{-1.0, -1.0, 0.0},     {1.0, 1.0, 1.0},    {0.0, 0.0}},
-    {{-1.0,  1.0, 0.0},     {0.0, 1.0, 1.0},    {0.0, 1.0}},
-    {{ 1.0,  1.0, 0.0},     {1.0, 1.0, 1.0},    {1.0, 1.0}},
-    {{ 1.0, -1.0, 0.0},     {0.0, 0.0, 1.0},    {1.0, 0.0}}
-};
-
-const std::vector<unsigned int> indices_quad =
-{
-    0, 1, 2,
-    2, 3, 0
-};
+    /* continuous recording of the window, toggled with M */
+    Capture capture;
+
+    Hud hud;
+    HudStats stats;
+
+    /* camera matrices of the previous frame, needed to reproject last frame's results */
+    Matrix4D prevProj;
+    Matrix4D prevView;
+
+    int width = 1280;
+    int height = 720;
+
+    /* framebuffer the final image is drawn into, 0 is the window */
+    GLuint targetFbo = 0;
+
+    /* number of frames written to trace.json by the cpu profiler */
+    unsigned int traceFrames = 120;
+} sScene;
 
 struct
 {
     bool mouseButtonPressed = false;
     Vector2D mousePressStart;
+    /* controls of the synchronous sceneUpdate (benchmark), interactive input goes to the simulation thread */
     bool keyPressed[Helicopter::eControl::CONTROL_COUNT] = {false, false, false, false, false, false, false, false};
 } sInput;
 
+/* hands input to the simulation thread, stamped with the time it happened */
+void sceneInput(InputEvent event)
+{
+    event.time = simulationTime();
+    simulationPush(sScene.sim, event);
+}
+
+void sceneInputControl(Helicopter::eControl control, int action)
+{
+    /* the simulation keeps the state, key repeats would only fill the queue */
+    if(action != GLFW_REPEAT)
+    {
+        sceneInput({InputEvent::CONTROL, 0.0, control, action == GLFW_PRESS});
+    }
+}
+
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
     /* input for camera control */
     if(key == GLFW_KEY_0 && action == GLFW_PRESS)
     {
-        sScene.cameraFollowHeli = false;
-        sScene.camera.lookAt = {0.0f, 0.0f, 0.0f};
-        cameraUpdateOrbit(sScene.camera, {0.0f, 0.0f}, 0.0f);
+        sceneInput({InputEvent::CAMERA_RESET});
     }
     if(key == GLFW_KEY_1 && action == GLFW_PRESS)
     {
-        sScene.cameraFollowHeli = false;
+        sceneInput({InputEvent::CAMERA_FOLLOW, 0.0, 0, false});
     }
     if(key == GLFW_KEY_2 && action == GLFW_PRESS)
     {
-        sScene.cameraFollowHeli = true;
+        sceneInput({InputEvent::CAMERA_FOLLOW, 0.0, 0, true});
     }
 
     /* input for helicopter control */
     if(key == GLFW_KEY_W)
     {
-        sInput.keyPressed[Helicopter::eControl::PITCH_DOWN] = (action == GLFW_PRESS || action == GLFW_REPEAT);
+        sceneInputControl(Helicopter::eControl::PITCH_DOWN, action);
     }
     if(key == GLFW_KEY_S)
     {
-        sInput.keyPressed[Helicopter::eControl::PITCH_UP] = (action == GLFW_PRESS || action == GLFW_REPEAT);
+        sceneInputControl(Helicopter::eControl::PITCH_UP, action);
     }
 
     if(key == GLFW_KEY_A)
     {
-        sInput.keyPressed[Helicopter::eControl::ROLL_LEFT] = (action == GLFW_PRESS || action == GLFW_REPEAT);
+        sceneInputControl(Helicopter::eControl::ROLL_LEFT, action);
     }
     if(key == GLFW_KEY_D)
     {
-        sInput.keyPressed[Helicopter::eControl::ROLL_RIGHT] = (action == GLFW_PRESS || action == GLFW_REPEAT);
+        sceneInputControl(Helicopter::eControl::ROLL_RIGHT, action);
     }
 
     if(key == GLFW_KEY_Q)
     {
-        sInput.keyPressed[Helicopter::eControl::YAW_LEFT] = (action == GLFW_PRESS || action == GLFW_REPEAT);
+        sceneInputControl(Helicopter::eControl::YAW_LEFT, action);
     }
     if(key == GLFW_KEY_E)
     {
-        sInput.keyPressed[Helicopter::eControl::YAW_RIGHT] = (action == GLFW_PRESS || action == GLFW_REPEAT);
+        sceneInputControl(Helicopter::eControl::YAW_RIGHT, action);
     }
 
     if(key == GLFW_KEY_LEFT_SHIFT)
     {
-        sInput.keyPressed[Helicopter::eControl::THROTTLE_UP] = (action == GLFW_PRESS || action == GLFW_REPEAT);
+        sceneInputControl(Helicopter::eControl::THROTTLE_UP, action);
     }
     if(key == GLFW_KEY_SPACE)
     {
-        sInput.keyPressed[Helicopter::eControl::THROTTLE_DOWN] = (action == GLFW_PRESS || action == GLFW_REPEAT);
+        sceneInputControl(Helicopter::eControl::THROTTLE_DOWN, action);
     }
 
     /* close window on escape */
@@ -122,19 +162,79 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
         glfwSetWindowShouldClose(window, true);
     }
 
+    /* cycle ssr trace resolution (full, half, quarter) */
+    if(key == GLFW_KEY_R && action == GLFW_PRESS)
+    {
+        ssrSetScale(sScene.ssr, sScene.ssr.scale == SSR::QUARTER ? SSR::FULL : sScene.ssr.scale * 2);
+        std::cout << "[SSR] tracing at 1/" << sScene.ssr.scale << " resolution" << std::endl;
+    }
+
+    /* toggle temporal accumulation of reflections */
+    if(key == GLFW_KEY_T && action == GLFW_PRESS)
+    {
+        ssrSetTemporal(sScene.ssr, !sScene.ssr.temporal);
+        std::cout << "[SSR] temporal accumulation " << (sScene.ssr.temporal ? "on" : "off") << std::endl;
+    }
+
+    /* toggle tile classification of reflections */
+    if(key == GLFW_KEY_C && action == GLFW_PRESS)
+    {
+        ssrSetTiled(sScene.ssr, !sScene.ssr.tiled);
+        std::cout << "[SSR] tile classification " << (sScene.ssr.tiled ? "on" : "off") << std::endl;
+    }
+
+    /* toggle dynamic resolution */
+    if(key == GLFW_KEY_V && action == GLFW_PRESS)
+    {
+        dynresSetEnabled(sScene.dynres, !sScene.dynres.enabled);
+        std::cout << "[DynRes] dynamic resolution " << (sScene.dynres.enabled ? "on" : "off") << std::endl;
+    }
+
+    /* toggle performance overlay */
+    if(key == GLFW_KEY_H && action == GLFW_PRESS)
+    {
+        sScene.hud.visible = !sScene.hud.visible;
+    }
+
+    /* dump cpu profiler trace of the last frames into the work directory */
+    if(key == GLFW_KEY_F && action == GLFW_PRESS)
+    {
+        cpuProfilerDump("trace.json", sScene.traceFrames);
+    }
+
+    /* start or stop recording the window into the work directory, frames are dropped if the encoders fall behind */
+    if(key == GLFW_KEY_M && action == GLFW_PRESS)
+    {
+        if(sScene.capture.worker)
+        {
+            captureDelete(sScene.capture);
+        }
+        else
+        {
+            sScene.capture = captureCreate("capture.y4m", sScene.width, sScene.height, 60, Capture::DROP);
+        }
+    }
+
+    /* toggle merging of draws that only differ in material */
+    if(key == GLFW_KEY_B && action == GLFW_PRESS)
+    {
+        sScene.batchMaterials = !sScene.batchMaterials;
+        std::cout << "[Scene] material batching " << (sScene.batchMaterials ? "on" : "off") << std::endl;
+    }
+
     /* make screenshot and save in work directory */
     if(key == GLFW_KEY_P && action == GLFW_PRESS)
     {
-        screenshotToPNG("screenshot.png");
+        screenshotQueueRequest(sScene.screenshots, "screenshot.png");
     }
 }
 
 void mousePosCallback(GLFWwindow* window, double x, double y)
 {
-    if(sInput.mouseButtonPressed)
+    if(sInput.mouseButtonPressed && !hudHovered(sScene.hud))
     {
         Vector2D diff = sInput.mousePressStart - Vector2D(x, y);
-        cameraUpdateOrbit(sScene.camera, diff, 0.0f);
+        sceneInput({InputEvent::ORBIT, 0.0, 0, false, diff});
         sInput.mousePressStart = Vector2D(x, y);
     }
 }
@@ -153,7 +253,7 @@ void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
 
 void mouseScrollCallback(GLFWwindow* window, double xoffset, double yoffset)
 {
-    cameraUpdateOrbit(sScene.camera, {0, 0}, sScene.zoomSpeedMultiplier * yoffset);
+    sceneInput({InputEvent::ZOOM, 0.0, 0, false, {float(sScene.zoomSpeedMultiplier * yoffset), 0.0f}});
 }
 
 void windowResizeCallback(GLFWwindow* window, int width, int height)
@@ -161,102 +261,226 @@ void windowResizeCallback(GLFWwindow* window, int width, int height)
     glViewport(0, 0, width, height);
     sScene.camera.width = width;
     sScene.camera.height = height;
+    sScene.width = width;
+    sScene.height = height;
+    sceneInput({InputEvent::RESIZE, 0.0, 0, false, Vector2D(width, height)});
 }
 
-void sceneInit(float width, float height)
+/* bytes of mip levels streamed textures may keep on the GPU */
+constexpr std::size_t TEXTURE_BUDGET = std::size_t(256) << 20;
+
+void sceneInit(float width, float height, bool streamTextures)
 {
     sScene.camera = cameraCreate(width, height, to_radians(45.0), 0.01, 200.0, {10.0, 10.0, 10.0}, {0.0, 0.0, 0.0});
     sScene.cameraFollowHeli = true;
     sScene.zoomSpeedMultiplier = 0.05f;
 
-    sScene.heli = helicopterLoad("assets/heli_low_poly/helicopter.obj");
-    sScene.modelGround = modelLoad("assets/ground/ground.obj").front();
+    /* streamed textures are drawn with a placeholder until they are decoded, all others are batched into arrays */
+    if(streamTextures)
+    {
+        registryStreamTextures(sScene.registry, TEXTURE_BUDGET);
+    }
+
+    sScene.heli = helicopterLoad("assets/heli_low_poly/helicopter.obj", sScene.registry);
+    sScene.modelGround = modelLoad("assets/ground/ground.obj", sScene.registry).front();
+    registryBatchTextures(sScene.registry);
 
-    // GBuffer and (future) SSR fragment shaders should be able to share the same vertex shader (for now)
-    sScene.shaderSSR = shaderLoad("shader/quad.vert", "shader/SSR.frag");
     sScene.shaderGBuffer = shaderLoad("shader/default.vert", "shader/gShader.frag");
 
-    /* Create gBuffer, attach textures for position, normals, color + spec and depth */
-    glGenFramebuffers(1, &gBuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, gBuffer);
-    
-    glGenTextures(1, &gPosition);
-    glBindTexture(GL_TEXTURE_2D, gPosition);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, gPosition, 0);
-
-    glGenTextures(1, &gNormal);
-    glBindTexture(GL_TEXTURE_2D, gNormal);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, gNormal, 0);
-    
-    glGenTextures(1, &gColorSpec);
-    glBindTexture(GL_TEXTURE_2D, gColorSpec);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, gColorSpec, 0);
-
-    glGenTextures(1, &gDepth);
-    glBindTexture(GL_TEXTURE_2D, gDepth);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, gDepth, 0);
-
-    GLuint buffers[3] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2};
-    glDrawBuffers(3, buffers);
-
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE){
-        printf("Framebuffer incomplete \n");
-    }
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    /* Code for binding vertex buffer objects, sourced from example 09_framebuffer */
-
-    /* generate vertex array object, and buffer */
-    glGenVertexArrays(1, &vao_quad);
-    glGenBuffers(1, &vbo_quad);
-    glGenBuffers(1, &ebo_quad);
-
-    /* bind buffer to vertex array object (remembers location of attribute data) */
-    glBindVertexArray(vao_quad);
-    {
-        /* upload data to buffer */
-        glBindBuffer(GL_ARRAY_BUFFER, vbo_quad);
-        glBufferData(GL_ARRAY_BUFFER, vertices_quad.size() * sizeof(Vex), vertices_quad.data(), GL_STATIC_DRAW);
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_quad);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices_quad.size() * sizeof(unsigned int), indices_quad.data(), GL_STATIC_DRAW);
-
-        /* enable attribute locations (see vertex shader) */
-        glEnableVertexAttribArray(eIndex::position);
-        glEnableVertexAttribArray(eIndex::color);
-        glEnableVertexAttribArray(eIndex::uV);
-        /* specify location of vertex attributes (see vertex shader) */
-        glVertexAttribPointer(eIndex::position, 3, GL_FLOAT, GL_FALSE, sizeof(Vex), (void*) offsetof(Vex, position));
-        glVertexAttribPointer(eIndex::color,    3, GL_FLOAT, GL_FALSE, sizeof(Vex), (void*) offsetof(Vex, color));
-        glVertexAttribPointer(eIndex::uV,       2, GL_FLOAT, GL_FALSE, sizeof(Vex), (void*) offsetof(Vex, uv));
-    }
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    sScene.width = width;
+    sScene.height = height;
+
+    /* render between half and full window resolution, aiming for 60 fps */
+    sScene.dynres = dynresCreate(0.5f, 1.0f, 16.0f);
+    sScene.gpuProfiler = gpuProfilerCreate(300);
+
+    sScene.gBuffer = gbufferCreate(width, height);
+    sScene.ssr = ssrCreate(width, height, SSR::FULL);
+
+    sScene.prevProj = cameraProjection(sScene.camera);
+    sScene.prevView = cameraView(sScene.camera);
 }
 
 void sceneUpdate(float dt)
 {
-    helicopterMove(sScene.heli, sInput.keyPressed, dt);
+    PROFILE_ZONE("sceneUpdate");
+
+    sScene.simAccumulator += dt;
+
+    unsigned int steps = 0;
+    while(sScene.simAccumulator >= sScene.sim.step && steps < sScene.sim.maxSteps)
+    {
+        helicopterMove(sScene.heli, sInput.keyPressed, sScene.sim.step);
+        sScene.simAccumulator -= sScene.sim.step;
+        steps++;
+    }
+
+    /* too far behind, drop the backlog instead of catching up over the next frames */
+    if(sScene.simAccumulator >= sScene.sim.step)
+    {
+        sScene.simAccumulator = std::fmod(sScene.simAccumulator, sScene.sim.step);
+    }
+
+    helicopterInterpolate(sScene.heli, sScene.simAccumulator / sScene.sim.step);
 
     if (sScene.cameraFollowHeli)
-        cameraFollow(sScene.camera, sScene.heli.position);
+        cameraFollow(sScene.camera, sceneGraphWorld(sScene.heli.graph, sScene.heli.node).column(3));
+}
+
+/* takes the newest state of the simulation thread and interpolates it to one step before now */
+void sceneSync()
+{
+    PROFILE_ZONE("sceneSync");
+
+    const SceneSnapshot& snapshot = simulationSnapshot(sScene.sim);
+
+    auto& heli = sScene.heli;
+    heli.prevPosition = snapshot.heliPosition[0];
+    heli.position = snapshot.heliPosition[1];
+    heli.prevAngles = snapshot.heliAngles[0];
+    heli.angles = snapshot.heliAngles[1];
+    heli.prevRotorRotation = snapshot.heliRotorRotation[0];
+    heli.rotorRotation = snapshot.heliRotorRotation[1];
+
+    double alpha = std::clamp((simulationTime() - snapshot.time) / sScene.sim.step, 0.0, 1.0);
+    helicopterInterpolate(heli, alpha);
+
+    sScene.camera = snapshot.camera;
+    sScene.camera.width = sScene.width;
+    sScene.camera.height = sScene.height;
+    sScene.cameraFollowHeli = snapshot.cameraFollowHeli;
+    if (sScene.cameraFollowHeli)
+        cameraFollow(sScene.camera, sceneGraphWorld(heli.graph, heli.node).column(3));
+}
+
+/* specular factor of a material as the strongest channel of its specular color (Ks) */
+float sceneMaterialSpecular(const Material& material)
+{
+    return std::max({material.specular.x, material.specular.y, material.specular.z});
+}
+
+/* whether pixels of a material are tagged reflective in the stencil buffer, same test as in the shaders */
+bool sceneMaterialReflective(const Material& material)
+{
+    return sceneMaterialSpecular(material) > SSR::SPEC_THRESHOLD;
+}
+
+/* sets the model matrix for the following gBuffer draws, the normal matrix is derived once here instead of per vertex */
+void sceneSetModel(const Affine3D& model)
+{
+    shaderUniform(sScene.shaderGBuffer, "uModel", model);
+    shaderUniform(sScene.shaderGBuffer, "uNormalMatrix", normalMatrix(model));
+}
+
+/* materials one gBuffer draw can switch between, has to match MAX_MATERIALS in gShader.frag */
+constexpr unsigned int MAX_DRAW_MATERIALS = 16;
+
+/* diffuse map of a material that is not a layer of an array (streamed or acquired after batching), 0 if none */
+GLuint sceneMaterialMap(const Material& material)
+{
+    if(material.diffuseMap == Material::NO_TEXTURE || material.diffuseArray != Material::NO_TEXTURE)
+    {
+        return 0;
+    }
+    return registryTextureGet(sScene.registry, material.diffuseMap).id;
+}
+
+/* draws the ranges of a model. With batching, consecutive ranges whose materials only differ in their constants or
+ * array layer are merged into one call, the shader picks the material by primitive id */
+void sceneDrawModel(const Model& model, const Affine3D& world)
+{
+    sceneSetModel(world);
+    glBindVertexArray(model.mesh.vao);
+
+    /* streamed textures keep the mip levels the model needs at its size on screen */
+    float scale = std::max({length(world.column(0)), length(world.column(1)), length(world.column(2))});
+    float screenSize = textureStreamerScreenSize(sScene.camera, transformPoint(world, model.center), scale * model.radius);
+    for(const auto& range : model.ranges)
+    {
+        const Material& material = registryMaterialGet(sScene.registry, range.material);
+        if(material.diffuseMap != Material::NO_TEXTURE)
+        {
+            registryTextureRequest(sScene.registry, material.diffuseMap, screenSize);
+        }
+    }
+
+    const auto& ranges = model.ranges;
+    for(std::size_t first = 0; first < ranges.size();)
+    {
+        const Material& firstMaterial = registryMaterialGet(sScene.registry, ranges[first].material);
+        unsigned int array = firstMaterial.diffuseArray;
+        GLuint map = sceneMaterialMap(firstMaterial);
+        bool reflective = sceneMaterialReflective(firstMaterial);
+
+        /* the stencil reference is per draw, so only materials with the same reflective tag are merged. A draw binds
+         * one array and one plain 2D map */
+        std::size_t last = first + 1;
+        while(sScene.batchMaterials && last < ranges.size() && last - first < MAX_DRAW_MATERIALS &&
+              ranges[last].indexOffset == ranges[last - 1].indexOffset + ranges[last - 1].indexCount)
+        {
+            const Material& nextMaterial = registryMaterialGet(sScene.registry, ranges[last].material);
+            unsigned int next = nextMaterial.diffuseArray;
+            GLuint nextMap = sceneMaterialMap(nextMaterial);
+            if((next != array && next != Material::NO_TEXTURE && array != Material::NO_TEXTURE) ||
+               (nextMap != map && nextMap != 0 && map != 0) ||
+               sceneMaterialReflective(nextMaterial) != reflective)
+            {
+                break;
+            }
+            array = std::min(array, next);
+            map = std::max(map, nextMap);
+            last++;
+        }
+
+        /* set material properties */
+        Vector3D diffuse[MAX_DRAW_MATERIALS];
+        float specular[MAX_DRAW_MATERIALS];
+        int layer[MAX_DRAW_MATERIALS];
+        int end[MAX_DRAW_MATERIALS];
+        unsigned int count = last - first;
+        unsigned int indexCount = 0;
+        for(unsigned int i = 0; i < count; i++)
+        {
+            const auto& range = ranges[first + i];
+            const Material& material = registryMaterialGet(sScene.registry, range.material);
+            diffuse[i] = material.diffuse;
+            specular[i] = sceneMaterialSpecular(material);
+            layer[i] = material.diffuseArray != Material::NO_TEXTURE ? int(material.diffuseLayer) : sceneMaterialMap(material) ? -2 : -1;
+            indexCount += range.indexCount;
+            end[i] = indexCount / 3;
+        }
+
+        shaderUniform(sScene.shaderGBuffer, "uMaterialCount", int(count));
+        shaderUniform(sScene.shaderGBuffer, "uMaterialEnd", end, count);
+        shaderUniform(sScene.shaderGBuffer, "uMaterialDiffuse", diffuse, count);
+        shaderUniform(sScene.shaderGBuffer, "uMaterialSpecular", specular, count);
+        shaderUniform(sScene.shaderGBuffer, "uMaterialLayer", layer, count);
+        if(array != Material::NO_TEXTURE)
+        {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, sScene.registry.arrays[array].array.id);
+        }
+        if(map != 0)
+        {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, map);
+            glActiveTexture(GL_TEXTURE0);
+        }
+
+        glStencilFunc(GL_ALWAYS, reflective ? SSR::STENCIL_REFLECTIVE : 0, 0xFF);
+
+        sScene.stats.drawCalls++;
+        sScene.stats.triangles += indexCount / 3;
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, (const void*) (ranges[first].indexOffset*sizeof(unsigned int)) );
+
+        first = last;
+    }
 }
 
 void sceneDraw()
 {
+    PROFILE_ZONE("sceneDraw");
+
     // Don't overdo it
     //glClearColor(135.0 / 255, 206.0 / 255, 235.0 / 255, 1.0);
     //glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -267,65 +491,67 @@ void sceneDraw()
         Matrix4D proj = cameraProjection(sScene.camera);
         Matrix4D view = cameraView(sScene.camera);
 
+        sScene.stats.drawCalls = 0;
+        sScene.stats.triangles = 0;
+
+        gpuProfilerBeginFrame(sScene.gpuProfiler);
+        gpuProfilerBegin(sScene.gpuProfiler, "frame");
+
+        /* reallocate render targets if the render resolution changed */
+        unsigned int width, height;
+        dynresSize(sScene.dynres, sScene.width, sScene.height, width, height);
+        if(width != sScene.gBuffer.width || height != sScene.gBuffer.height)
+        {
+            gbufferDelete(sScene.gBuffer);
+            sScene.gBuffer = gbufferCreate(width, height);
+            ssrResize(sScene.ssr, width, height);
+        }
+
         /* Draw scene to gBuffer */
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gBuffer);
+        gpuProfilerBegin(sScene.gpuProfiler, "gbuffer");
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, sScene.gBuffer.fbo);
+        glViewport(0, 0, width, height);
         {
             glClearColor(135.0 / 255, 206.0 / 255, 235.0 / 255, 1.0);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
             glEnable(GL_DEPTH_TEST);
             glDepthFunc(GL_LESS); 
 
+            /* the visible surface decides whether a pixel gets reflections */
+            glEnable(GL_STENCIL_TEST);
+            glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+
             glUseProgram(sScene.shaderGBuffer.id);
 
             shaderUniform(sScene.shaderGBuffer, "uProj",  proj);
             shaderUniform(sScene.shaderGBuffer, "uView",  view);
-            shaderUniform(sScene.shaderGBuffer, "uModel",  sScene.heli.transformation);
+            shaderUniform(sScene.shaderGBuffer, "uDiffuseMaps", 0);
+            shaderUniform(sScene.shaderGBuffer, "uDiffuseMap", 1);
 
             /* render heli -> having a moving object actually helps with debugging the SSR shader */
             for(unsigned int i = 0; i < sScene.heli.partModel.size(); i++)
             {
-                auto& model = sScene.heli.partModel[i];
-                auto& transform = sScene.heli.partTransformations[i];
-                glBindVertexArray(model.mesh.vao);
-
-                shaderUniform(sScene.shaderGBuffer, "uModel", sScene.heli.transformation * transform);
-
-                for(auto& material : model.material)
-                {
-                    /* set material properties */
-                    shaderUniform(sScene.shaderGBuffer, "uMaterial.diffuse", material.diffuse);
-                    // Specular component hardcoded until we get it working
-                    shaderUniform(sScene.shaderGBuffer, "uSpec", 0.0f);
-
-                    glDrawElements(GL_TRIANGLES, material.indexCount, GL_UNSIGNED_INT, (const void*) (material.indexOffset*sizeof(unsigned int)) );
-                }
+                sceneDrawModel(sScene.heli.partModel[i], sceneGraphWorld(sScene.heli.graph, sScene.heli.partNodes[i]));
             }
 
             /* render ground */
-            shaderUniform(sScene.shaderGBuffer, "uModel", Matrix4D::scale(4.0, 4.0, 4.0));
-            glBindVertexArray(sScene.modelGround.mesh.vao);
-
-            for(auto& material : sScene.modelGround.material)
-            {
-                /* set material properties */
-                shaderUniform(sScene.shaderGBuffer, "uMaterial.diffuse", material.diffuse);
-                // Specular component hardcoded until we get it working
-                shaderUniform(sScene.shaderGBuffer, "uSpec", 0.7f);
+            sceneDrawModel(sScene.modelGround, Affine3D::scale(4.0, 4.0, 4.0));
 
-                glDrawElements(GL_TRIANGLES, material.indexCount, GL_UNSIGNED_INT, (const void*) (material.indexOffset*sizeof(unsigned int)) );
-            }
+            glDisable(GL_STENCIL_TEST);
         }
+        gpuProfilerEnd(sScene.gpuProfiler);
 
-        /* Switch draw buffer back to screen */
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        /* Switch draw buffer back to screen (or the offscreen target) */
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, sScene.targetFbo);
+        glViewport(0, 0, sScene.width, sScene.height);
         {
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
             glDisable(GL_DEPTH_TEST);
 
             /* This is just for displaying our textures, we felt like leaving it in, just in case
-            glBindFramebuffer(GL_READ_FRAMEBUFFER, gBuffer);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, sScene.gBuffer.fbo);
 
             GLsizei HalfWidth = (GLsizei)(sScene.width / 2.0f);
             GLsizei HalfHeight = (GLsizei)(sScene.height / 2.0f);
@@ -333,10 +559,10 @@ void sceneDraw()
             // Blit position, normals and color information to screen (this works and displays the correct images)
 
             glReadBuffer(GL_COLOR_ATTACHMENT0);
-            glBlitNamedFramebuffer(gBuffer, 0, 0, 0, sScene.width, sScene.height, 0, 0, HalfWidth, HalfHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+            glBlitNamedFramebuffer(sScene.gBuffer.fbo, 0, 0, 0, sScene.width, sScene.height, 0, 0, HalfWidth, HalfHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
 
             glReadBuffer(GL_COLOR_ATTACHMENT0 + 1);
-            glBlitNamedFramebuffer(gBuffer, 0, 0, 0, sScene.width, sScene.height, 0, HalfHeight, HalfWidth, sScene.height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+            glBlitNamedFramebuffer(sScene.gBuffer.fbo, 0, 0, 0, sScene.width, sScene.height, 0, HalfHeight, HalfWidth, sScene.height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
 
             glReadBuffer(GL_COLOR_ATTACHMENT0 + 2);
             glBlitFramebuffer(0, 0, sScene.width, sScene.height, HalfWidth, HalfHeight, sScene.width, sScene.height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
@@ -347,29 +573,30 @@ void sceneDraw()
             glBlitFramebuffer(0, 0, sScene.width, sScene.height, HalfWidth, 0, sScene.width, HalfHeight, GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT, GL_NEAREST);
             */
 
-            glUseProgram(sScene.shaderSSR.id);
+            /* trace reflections and composite them onto the scene, upscaled to the window */
+            ssrDraw(sScene.ssr, sScene.gpuProfiler, sScene.gBuffer, proj, view, sScene.prevProj, sScene.prevView);
 
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, gPosition);
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, gNormal);
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, gColorSpec);
-            glActiveTexture(GL_TEXTURE3);
-            glBindTexture(GL_TEXTURE_2D, gDepth);
-
-            shaderUniform(sScene.shaderSSR, "uProj",  proj);
-            shaderUniform(sScene.shaderSSR, "uInvProj",  inverse(proj));
+            /* overlay is part of the measured frame, so its own cost shows up in the timings */
+            std::uint64_t hudStart = cpuProfilerNow();
+            gpuProfilerBegin(sScene.gpuProfiler, "hud");
+            hudDraw(sScene.hud, sScene.stats, sScene.gpuProfiler, sScene.gBuffer, sScene.ssr);
+            gpuProfilerEnd(sScene.gpuProfiler);
+            sScene.stats.cpuHudMs = (cpuProfilerNow() - hudStart) * 1e-6;
+        }
 
-            /* draw content in vertex array */
-            glBindVertexArray(vao_quad);
-            {
-                glDrawElements(GL_TRIANGLES, indices_quad.size(), GL_UNSIGNED_INT, (void*) 0);
-            }
-            glBindVertexArray(0);
+        gpuProfilerEnd(sScene.gpuProfiler);
+        gpuProfilerEndFrame(sScene.gpuProfiler);
+        dynresUpdate(sScene.dynres, sScene.gpuProfiler);
 
+        /* stream the textures requested by this frame's draws, new levels are used from the next frame on */
+        if(sScene.registry.streaming)
+        {
+            textureStreamerUpdate(sScene.registry.streamer);
         }
 
+        sScene.prevProj = proj;
+        sScene.prevView = view;
+
     }
 
     /* cleanup opengl state */
@@ -377,53 +604,238 @@ void sceneDraw()
     glUseProgram(0);
 }
 
+/* renders the scripted benchmark at a fixed timestep into an offscreen framebuffer and writes the timings report */
+bool sceneBenchmark(Benchmark& bench)
+{
+    /* fixed resolution and every gpu result, independent of how fast the machine is */
+    dynresSetEnabled(sScene.dynres, false);
+    sScene.dynres.log = false;
+    sScene.gpuProfiler.printInterval = 0;
+    sScene.gpuProfiler.record = true;
+    sScene.cameraFollowHeli = true;
+
+    Framebuffer target = framebufferCreate(bench.width, bench.height);
+    sScene.targetFbo = target.fbo;
+
+    /* the recording has to contain every frame, so capturing stalls the run instead of dropping */
+    Capture capture;
+    if(!bench.capturePath.empty())
+    {
+        capture = captureCreate(bench.capturePath, bench.width, bench.height, std::lround(1.0f / bench.timestep), Capture::STALL);
+    }
+
+    while(!benchmarkDone(bench))
+    {
+        PROFILE_FRAME();
+
+        /* glfw timers are not available with an offscreen context */
+        BenchmarkFrame frame;
+        std::uint64_t frameStart = cpuProfilerNow();
+
+        benchmarkScript(bench, sInput.keyPressed, sScene.camera);
+        sceneUpdate(bench.timestep);
+        std::uint64_t updateEnd = cpuProfilerNow();
+
+        sceneDraw();
+        std::uint64_t drawEnd = cpuProfilerNow();
+
+        frame.cpuUpdateMs = (updateEnd - frameStart) * 1e-6;
+        frame.cpuDrawMs = (drawEnd - updateEnd) * 1e-6;
+        frame.cpuFrameMs = (drawEnd - frameStart) * 1e-6;
+        benchmarkEndFrame(bench, frame);
+
+        captureFrame(capture, target.fbo);
+    }
+
+    captureDelete(capture);
+
+    gpuProfilerFlush(sScene.gpuProfiler);
+    bool written = benchmarkWriteReport(bench, sScene.gpuProfiler);
+
+    if(!bench.screenshotPath.empty())
+    {
+        screenshotToPNG(bench.screenshotPath, target.fbo);
+    }
+
+    sScene.targetFbo = 0;
+    framebufferDelete(target);
+
+    return written;
+}
+
 int main(int argc, char** argv)
 {
+    PROFILE_THREAD("main");
+
+    /* --trace: write the cpu profiler trace of the last frames to trace.json on exit
+     * --benchmark [--frames N] [--timestep S] [--report PATH] [--screenshot PATH]: render a scripted flight without
+     *   window and vsync, optionally saving the last frame
+     * --capture PATH: record every benchmark frame to a .y4m video or numbered pngs
+     * --offscreen: same as --benchmark, but without any display (EGL context)
+     * --stream: stream textures in the background in --benchmark too, the output then depends on decode timing */
+    bool traceOnExit = false;
+    bool benchmark = false;
+    bool offscreen = false;
+    bool streamTextures = false;
+    unsigned int benchFrames = 600;
+    float benchTimestep = 1.0f / 60.0f;
+    std::string benchReport = "benchmark.json";
+    std::string benchScreenshot;
+    std::string benchCapture;
+    for(int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if(std::strcmp(argv[i], "--trace") == 0)
+        {
+            traceOnExit = true;
+        }
+        else if(std::strcmp(argv[i], "--benchmark") == 0)
+        {
+            benchmark = true;
+        }
+        else if(std::strcmp(argv[i], "--offscreen") == 0)
+        {
+            benchmark = true;
+            offscreen = true;
+        }
+        else if(std::strcmp(argv[i], "--stream") == 0)
+        {
+            streamTextures = true;
+        }
+        else if(std::strcmp(argv[i], "--frames") == 0 && hasValue)
+        {
+            benchFrames = std::max(1, std::atoi(argv[++i]));
+        }
+        else if(std::strcmp(argv[i], "--timestep") == 0 && hasValue)
+        {
+            benchTimestep = std::max(1e-4, std::atof(argv[++i]));
+        }
+        else if(std::strcmp(argv[i], "--report") == 0 && hasValue)
+        {
+            benchReport = argv[++i];
+        }
+        else if(std::strcmp(argv[i], "--screenshot") == 0 && hasValue)
+        {
+            benchScreenshot = argv[++i];
+        }
+        else if(std::strcmp(argv[i], "--capture") == 0 && hasValue)
+        {
+            benchCapture = argv[++i];
+        }
+        else
+        {
+            std::cerr << "unknown argument " << argv[i] << std::endl;
+        }
+    }
+
     /*---------- init window ------------*/
     int width = 1280;
     int height = 720;
-    GLFWwindow* window = windowCreate("Why it no work", width, height);
-    if(!window) { return EXIT_FAILURE; }
-
-    /* set window callbacks */
-    glfwSetKeyCallback(window, keyCallback);
-    glfwSetCursorPosCallback(window, mousePosCallback);
-    glfwSetMouseButtonCallback(window, mouseButtonCallback);
-    glfwSetScrollCallback(window, mouseScrollCallback);
-    glfwSetFramebufferSizeCallback(window, windowResizeCallback);
+    GLFWwindow* window = nullptr;
+    OffscreenContext offscreenContext;
+    if(offscreen)
+    {
+        offscreenContext = offscreenCreate(width, height);
+        if(!offscreenValid(offscreenContext)) { return EXIT_FAILURE; }
+    }
+    else
+    {
+        window = windowCreate("Why it no work", width, height, !benchmark, !benchmark);
+        if(!window) { return EXIT_FAILURE; }
+
+        /* set window callbacks */
+        glfwSetKeyCallback(window, keyCallback);
+        glfwSetCursorPosCallback(window, mousePosCallback);
+        glfwSetMouseButtonCallback(window, mouseButtonCallback);
+        glfwSetScrollCallback(window, mouseScrollCallback);
+        glfwSetFramebufferSizeCallback(window, windowResizeCallback);
+    }
 
     /*---------- init opengl stuff ------------*/
     glEnable(GL_DEPTH_TEST);
 
     /* setup scene */
-    sceneInit(width, height);
+    sceneInit(width, height, !benchmark || streamTextures);
+    sScene.hud = hudCreate(window);
+
+    bool benchmarkFailed = false;
+    if(benchmark)
+    {
+        Benchmark bench = benchmarkCreate(benchFrames, benchTimestep, benchReport, width, height);
+        bench.screenshotPath = benchScreenshot;
+        bench.capturePath = benchCapture;
+        benchmarkFailed = !sceneBenchmark(bench);
+    }
+    else
+    {
+        simulationStart(sScene.sim, sScene.heli, sScene.camera, sScene.cameraFollowHeli);
+        sScene.screenshots = screenshotQueueCreate();
+    }
 
     /*-------------- main loop ----------------*/
-    double timeStamp = glfwGetTime();
-    double timeStampNew = 0.0;
-    while(!glfwWindowShouldClose(window))
+    /* profiler clock instead of glfwGetTime, glfw is not initialized with an offscreen context */
+    std::uint64_t timeStamp = cpuProfilerNow();
+    std::uint64_t timeStampNew = 0;
+    while(!benchmark && !glfwWindowShouldClose(window))
     {
+        PROFILE_FRAME();
+
         /* poll and process input and window events */
-        glfwPollEvents();
+        {
+            PROFILE_ZONE("pollEvents");
+            glfwPollEvents();
+        }
 
-        /* update scene */
-        timeStampNew = glfwGetTime();
-        sceneUpdate(timeStampNew - timeStamp);
+        /* pick up the simulated scene, the simulation thread keeps running while this frame is drawn */
+        timeStampNew = cpuProfilerNow();
+        sScene.stats.cpuFrameMs = (timeStampNew - timeStamp) * 1e-6;
+        sceneSync();
         timeStamp = timeStampNew;
+        sScene.stats.cpuUpdateMs = (cpuProfilerNow() - timeStampNew) * 1e-6;
 
         /* draw all objects in the scene */
+        std::uint64_t drawStart = cpuProfilerNow();
         sceneDraw();
+        sScene.stats.cpuDrawMs = (cpuProfilerNow() - drawStart) * 1e-6;
 
         /* swap front and back buffer */
-        glfwSwapBuffers(window);
+        {
+            PROFILE_ZONE("swapBuffers");
+            glfwSwapBuffers(window);
+        }
+
+        screenshotQueuePoll(sScene.screenshots);
+        captureFrame(sScene.capture);
     }
 
 
     /*-------- cleanup --------*/
-    helicopterDelete(sScene.heli);
-    shaderDelete(sScene.shaderSSR);
+    simulationStop(sScene.sim);
+
+    if(traceOnExit)
+    {
+        cpuProfilerDump("trace.json", sScene.traceFrames);
+    }
+
+    ssrReport(sScene.ssr, sScene.gpuProfiler);
+    gpuProfilerPrint(sScene.gpuProfiler);
+    registryReport(sScene.registry);
+
+    captureDelete(sScene.capture);
+    screenshotQueueDelete(sScene.screenshots);
+    hudDelete(sScene.hud);
+    helicopterDelete(sScene.heli, sScene.registry);
+    modelDelete(sScene.modelGround, sScene.registry);
+    registryDelete(sScene.registry);
     shaderDelete(sScene.shaderGBuffer);
-    windowDelete(window);
+    ssrDelete(sScene.ssr);
+    gbufferDelete(sScene.gBuffer);
+    gpuProfilerDelete(sScene.gpuProfiler);
+    if(window)
+    {
+        windowDelete(window);
+    }
+    offscreenDelete(offscreenContext);
 
-    return EXIT_SUCCESS;
+    return benchmarkFailed ? EXIT_FAILURE : EXIT_SUCCESS;
 }
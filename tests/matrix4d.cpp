@@ -0,0 +1,126 @@
+#include "math/matrix4d.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+/* compares the SSE2 paths of Matrix4D against the scalar reference on random matrices, exits with 1 on mismatch */
+
+namespace
+{
+
+constexpr unsigned int MATRIX_COUNT = 10000;
+
+/* float reassociation differs between the paths, errors are relative to the magnitude of the values involved */
+constexpr float PRODUCT_TOLERANCE = 1e-5f;
+constexpr float INVERSE_TOLERANCE = 1e-3f;
+
+float maxAbs(const Matrix4D& M)
+{
+    float m = 0.0f;
+    for(int i = 0; i < 4; i++)
+    {
+        for(int j = 0; j < 4; j++)
+        {
+            m = std::max(m, std::fabs(M(i, j)));
+        }
+    }
+    return m;
+}
+
+float maxError(const Matrix4D& A, const Matrix4D& B)
+{
+    float m = 0.0f;
+    for(int i = 0; i < 4; i++)
+    {
+        for(int j = 0; j < 4; j++)
+        {
+            m = std::max(m, std::fabs(A(i, j) - B(i, j)));
+        }
+    }
+    return m;
+}
+
+float maxError(const Vector4D& a, const Vector4D& b)
+{
+    return std::max({std::fabs(a.x - b.x), std::fabs(a.y - b.y), std::fabs(a.z - b.z), std::fabs(a.w - b.w)});
+}
+
+Matrix4D randomMatrix(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+
+    Matrix4D M;
+    for(int i = 0; i < 4; i++)
+    {
+        for(int j = 0; j < 4; j++)
+        {
+            M(i, j) = value(rng);
+        }
+    }
+    return M;
+}
+
+/* random matrix with a dominant diagonal, far enough from singular that the inverse is well conditioned */
+Matrix4D randomInvertible(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> sign(-1.0f, 1.0f);
+
+    Matrix4D M = randomMatrix(rng);
+    for(int i = 0; i < 4; i++)
+    {
+        M(i, i) = (sign(rng) < 0.0f ? -50.0f : 50.0f) + M(i, i);
+    }
+    return M;
+}
+
+bool check(const char* name, float error, float tolerance)
+{
+    bool passed = error <= tolerance;
+    std::cout << "    " << name << ": max relative error " << error << (passed ? "" : " FAILED") << std::endl;
+    return passed;
+}
+
+}
+
+int main()
+{
+#ifndef MATRIX4D_SSE2
+    std::cout << "[Matrix4DTest] built without SSE2, nothing to compare" << std::endl;
+    return 0;
+#else
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+
+    float productError = 0.0f;
+    float transformError = 0.0f;
+    float inverseError = 0.0f;
+
+    for(unsigned int i = 0; i < MATRIX_COUNT; i++)
+    {
+        Matrix4D A = randomMatrix(rng);
+        Matrix4D B = randomMatrix(rng);
+        Vector4D v(value(rng), value(rng), value(rng), value(rng));
+
+        /* every entry is a sum of four products, bounded by 4 * |A| * |B| */
+        float productScale = 4.0f * maxAbs(A) * maxAbs(B);
+        productError = std::max(productError, maxError(A * B, detail::matrix4dMulScalar(A, B)) / productScale);
+
+        float transformScale = 4.0f * maxAbs(A) * std::max({std::fabs(v.x), std::fabs(v.y), std::fabs(v.z), std::fabs(v.w)});
+        transformError = std::max(transformError, maxError(A * v, detail::matrix4dTransformScalar(A, v)) / transformScale);
+
+        Matrix4D M = randomInvertible(rng);
+        Matrix4D reference = detail::matrix4dInverseScalar(M);
+        inverseError = std::max(inverseError, maxError(inverse(M), reference) / maxAbs(reference));
+    }
+
+    std::cout << "[Matrix4DTest] " << MATRIX_COUNT << " random matrices, SSE2 against scalar" << std::endl;
+
+    bool passed = check("Matrix4D * Matrix4D", productError, PRODUCT_TOLERANCE);
+    passed = check("Matrix4D * Vector4D", transformError, PRODUCT_TOLERANCE) && passed;
+    passed = check("inverse(Matrix4D)", inverseError, INVERSE_TOLERANCE) && passed;
+
+    return passed ? 0 : 1;
+#endif
+}